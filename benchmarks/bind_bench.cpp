@@ -0,0 +1,160 @@
+#include "json_bind.h"
+#include "json_parser.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Item {
+    int64_t id = 0;
+    std::string sku;
+    double price = 0;
+    uint32_t quantity = 0;
+};
+JSON_BIND(Item, id, sku, price, quantity)
+
+struct Order {
+    int64_t orderId = 0;
+    std::string customer;
+    std::string status;
+    bool paid = false;
+    double total = 0;
+    std::vector<std::string> tags;
+    std::vector<Item> items;
+};
+JSON_BIND(Order, orderId, customer, status, paid, total, tags, items)
+
+// 典型的订单消息
+std::vector<std::string> makeMessages(size_t count) {
+    std::mt19937_64 rng(42);
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < count; ++i) {
+        std::string items;
+        size_t itemCount = 1 + rng() % 4;
+        for (size_t j = 0; j < itemCount; ++j) {
+            items += (j ? ", " : "") + std::string("{\"id\": ") + std::to_string(rng() % 100000) +
+                     ", \"sku\": \"SKU-" + std::to_string(rng() % 10000) + "\", \"price\": " +
+                     std::to_string((rng() % 10000) / 100.0) + ", \"quantity\": " +
+                     std::to_string(1 + rng() % 5) + "}";
+        }
+        messages.push_back("{\"orderId\": " + std::to_string(1000000 + i) +
+                           ", \"customer\": \"customer-" + std::to_string(rng() % 5000) +
+                           "\", \"status\": \"" + (rng() % 3 ? "shipped" : "pending") +
+                           "\", \"paid\": true, \"total\": " + std::to_string((rng() % 100000) / 100.0) +
+                           ", \"tags\": [\"web\", \"priority\"], \"items\": [" + items + "]}");
+    }
+    return messages;
+}
+
+// 先解析成 JsonValue 再逐个字段取出
+Order extract(const json::JsonValue& value) {
+    const auto& object = value.asObject();
+    Order order;
+    order.orderId = object.at("orderId").asInt64();
+    order.customer = object.at("customer").asString();
+    order.status = object.at("status").asString();
+    order.paid = object.at("paid").asBoolean();
+    order.total = object.at("total").asNumber();
+    for (const auto& tag : object.at("tags").asArray()) {
+        order.tags.push_back(tag.asString());
+    }
+    for (const auto& element : object.at("items").asArray()) {
+        const auto& fields = element.asObject();
+        Item item;
+        item.id = fields.at("id").asInt64();
+        item.sku = fields.at("sku").asString();
+        item.price = fields.at("price").asNumber();
+        item.quantity = static_cast<uint32_t>(fields.at("quantity").asInt64());
+        order.items.push_back(std::move(item));
+    }
+    return order;
+}
+
+json::JsonValue toValue(const Order& order) {
+    json::JsonValue::Object object;
+    object["orderId"] = json::JsonValue(order.orderId);
+    object["customer"] = json::JsonValue(order.customer);
+    object["status"] = json::JsonValue(order.status);
+    object["paid"] = json::JsonValue(order.paid);
+    object["total"] = json::JsonValue(order.total);
+    json::JsonValue::Array tags;
+    for (const auto& tag : order.tags) {
+        tags.push_back(json::JsonValue(tag));
+    }
+    object["tags"] = json::JsonValue(std::move(tags));
+    json::JsonValue::Array items;
+    for (const auto& item : order.items) {
+        json::JsonValue::Object fields;
+        fields["id"] = json::JsonValue(item.id);
+        fields["sku"] = json::JsonValue(item.sku);
+        fields["price"] = json::JsonValue(item.price);
+        fields["quantity"] = json::JsonValue(static_cast<int64_t>(item.quantity));
+        items.push_back(json::JsonValue(std::move(fields)));
+    }
+    object["items"] = json::JsonValue(std::move(items));
+    return json::JsonValue(std::move(object));
+}
+
+template <typename Body>
+double measure(double megabytes, size_t rounds, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+        body();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return megabytes * rounds / std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+
+    std::vector<std::string> messages = makeMessages(count);
+    size_t bytes = 0;
+    for (const auto& message : messages) {
+        bytes += message.size();
+    }
+    double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::cout << "input:              " << count << " messages, " << std::fixed
+              << std::setprecision(1) << megabytes << " MB" << std::endl;
+
+    size_t checksum = 0;
+    double extracted = measure(megabytes, rounds, [&] {
+        for (const auto& message : messages) {
+            checksum += extract(json::JsonParser(message).parse()).items.size();
+        }
+    });
+    Order order;
+    double bound = measure(megabytes, rounds, [&] {
+        for (const auto& message : messages) {
+            json::decode(message, order);
+            checksum += order.items.size();
+        }
+    });
+    std::cout << "parse + extract:    " << std::setprecision(1) << extracted << " MB/s" << std::endl;
+    std::cout << "bound decode:       " << bound << " MB/s, " << std::setprecision(2)
+              << bound / extracted << "x" << std::endl;
+
+    std::vector<Order> orders;
+    for (const auto& message : messages) {
+        orders.push_back(json::decode<Order>(message));
+    }
+    double built = measure(megabytes, rounds, [&] {
+        for (const auto& o : orders) {
+            checksum += toValue(o).toString().size();
+        }
+    });
+    double encoded = measure(megabytes, rounds, [&] {
+        for (const auto& o : orders) {
+            checksum += json::encode(o).size();
+        }
+    });
+    std::cout << "build + toString:   " << std::setprecision(1) << built << " MB/s" << std::endl;
+    std::cout << "bound encode:       " << encoded << " MB/s, " << std::setprecision(2)
+              << encoded / built << "x" << std::endl;
+    std::cout << "checksum:           " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "json_cbor.h"
+#include "json_parser.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+// 由服务间消息组成的数组
+std::string makeMessages(size_t count) {
+    std::mt19937_64 rng(42);
+    std::string out = "[";
+    for (size_t i = 0; i < count; ++i) {
+        out += (i ? ",\n" : "") + std::string("{\"id\": ") + std::to_string(1000000 + i) +
+               ", \"service\": \"svc-" + std::to_string(rng() % 50) + "\", \"latency\": " +
+               std::to_string((rng() % 100000) / 1000.0) + ", \"ok\": " + (rng() % 10 ? "true" : "false") +
+               ", \"retries\": " + std::to_string(rng() % 4) + ", \"tags\": [\"web\", \"eu-west\"]" +
+               ", \"user\": {\"id\": " + std::to_string(rng() % 1000000) +
+               ", \"name\": \"user-" + std::to_string(rng() % 100000) + "\", \"admin\": null}}";
+    }
+    return out + "]";
+}
+
+template <typename Body>
+double seconds(size_t rounds, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+        body();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count() / rounds;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5;
+
+    std::string text = makeMessages(count);
+    json::JsonValue value = json::JsonParser(text).parse();
+    std::string compact = value.toString();
+    std::string cbor = json::toCbor(value);
+
+    const double mb = 1024.0 * 1024.0;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "documents:          " << count << " messages" << std::endl;
+    std::cout << "size:               " << compact.size() / mb << " MB text, " << cbor.size() / mb
+              << " MB CBOR (" << std::setprecision(0) << 100.0 * cbor.size() / compact.size() << "%)"
+              << std::endl;
+
+    size_t checksum = 0;
+    double toString = seconds(rounds, [&] { checksum += value.toString().size(); });
+    double toCbor = seconds(rounds, [&] { checksum += json::toCbor(value).size(); });
+    double parse = seconds(rounds, [&] { checksum += json::JsonParser(compact).parse().asArray().size(); });
+    double parseCbor = seconds(rounds, [&] { checksum += json::parseCbor(cbor).asArray().size(); });
+    double skip = seconds(rounds, [&] { checksum += json::skipCbor(cbor); });
+
+    // 吞吐量以文本大小计，两种格式可直接比较
+    double textMb = compact.size() / mb;
+    std::cout << std::setprecision(1);
+    std::cout << "encode text:        " << textMb / toString << " MB/s" << std::endl;
+    std::cout << "encode CBOR:        " << textMb / toCbor << " MB/s, " << std::setprecision(2)
+              << toString / toCbor << "x" << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "decode text:        " << textMb / parse << " MB/s" << std::endl;
+    std::cout << "decode CBOR:        " << textMb / parseCbor << " MB/s, " << std::setprecision(2)
+              << parse / parseCbor << "x" << std::endl;
+    std::cout << std::setprecision(1);
+    std::cout << "skip CBOR:          " << textMb / skip << " MB/s" << std::endl;
+    std::cout << "checksum:           " << checksum << std::endl;
+    return 0;
+}
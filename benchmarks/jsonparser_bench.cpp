@@ -0,0 +1,506 @@
+#include "json_document.h"
+#include "json_ndjson.h"
+#include "json_parser.h"
+#include "json_validate.h"
+#include "json_writer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+// 统计堆分配次数，用于计算每个文档的分配次数
+std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+struct Options {
+    bool quick = false;
+    double minTime = 0.5;        // Seconds of measurement per benchmark
+    size_t minSamples = 5;
+    std::string filter;          // Substring of benchmark names to run
+    std::string jsonPath;        // Write results here
+    std::string baselinePath;    // Compare against an earlier --json file
+    double threshold = 10.0;     // Percent slowdown that counts as a regression
+};
+
+struct Corpus {
+    std::string name;
+    std::vector<std::string> documents;
+    size_t bytes = 0;
+};
+
+struct Result {
+    std::string name;
+    size_t bytes;
+    size_t documents;
+    double seconds;        // Median time of one pass over the corpus
+    double mbPerSecond;
+    double docsPerSecond;
+    double allocsPerDoc;
+    size_t peakRssKb;
+};
+
+// ---------------------------------------------------------------------------
+// 语料生成，固定种子保证每次运行的输入相同
+
+std::string pick(std::mt19937_64& rng, const std::vector<std::string>& words) {
+    return words[rng() % words.size()];
+}
+
+// 类似 twitter.json：嵌套对象、Unicode 文本和大整数 id
+std::string makeTwitter(std::mt19937_64& rng, size_t statuses) {
+    static const std::vector<std::string> words = {
+        "json", "parser", "fast", "\\u00e9t\\u00e9", "\xe4\xbd\xa0\xe5\xa5\xbd", "\xf0\x9f\x9a\x80",
+        "release", "benchmark", "simd", "\\\"quoted\\\"", "line\\nbreak", "https://t.co/x"};
+    std::string out = "{\"statuses\": [";
+    for (size_t i = 0; i < statuses; ++i) {
+        uint64_t id = 505874924095815681ull + rng() % 1000000;
+        std::string text;
+        for (int w = 0; w < 12; ++w) {
+            text += (w ? " " : "") + pick(rng, words);
+        }
+        out += (i ? ", " : "") + std::string("{\"created_at\": \"Sun Aug 31 00:29:15 +0000 2014\", ") +
+               "\"id\": " + std::to_string(id) + ", \"id_str\": \"" + std::to_string(id) + "\", " +
+               "\"text\": \"" + text + "\", \"truncated\": false, " +
+               "\"entities\": {\"hashtags\": [{\"text\": \"" + pick(rng, words) + "\", \"indices\": [" +
+               std::to_string(rng() % 100) + ", " + std::to_string(rng() % 140) + "]}], " +
+               "\"urls\": [], \"user_mentions\": [{\"screen_name\": \"user" + std::to_string(rng() % 1000) +
+               "\", \"id\": " + std::to_string(rng() % 100000000) + ", \"indices\": [0, 12]}]}, " +
+               "\"user\": {\"id\": " + std::to_string(rng() % 3000000000ull) + ", \"name\": \"" +
+               pick(rng, words) + "\", \"screen_name\": \"u" + std::to_string(rng() % 100000) +
+               "\", \"description\": \"" + text + "\", \"followers_count\": " +
+               std::to_string(rng() % 100000) + ", \"verified\": " + (rng() % 2 ? "true" : "false") +
+               ", \"profile_image_url\": \"http://pbs.twimg.com/profile_images/" +
+               std::to_string(rng() % 1000000) + "/a.png\"}, " +
+               "\"geo\": null, \"coordinates\": null, \"retweet_count\": " + std::to_string(rng() % 1000) +
+               ", \"favorite_count\": " + std::to_string(rng() % 1000) +
+               ", \"favorited\": false, \"lang\": \"ja\"}";
+    }
+    return out + "], \"search_metadata\": {\"completed_in\": 0.087, \"max_id\": 505874924095815681, " +
+           "\"query\": \"%23json\", \"count\": " + std::to_string(statuses) + "}}";
+}
+
+// 类似 canada.json：GeoJSON 多边形，大量高精度浮点坐标
+std::string makeCanada(std::mt19937_64& rng, size_t rings, size_t points) {
+    std::uniform_real_distribution<double> lon(-141.0, -52.0);
+    std::uniform_real_distribution<double> lat(41.0, 83.0);
+    char buffer[64];
+    std::string out = "{\"type\": \"FeatureCollection\", \"features\": [{\"type\": \"Feature\", "
+                      "\"properties\": {\"name\": \"Canada\"}, \"geometry\": {\"type\": \"Polygon\", "
+                      "\"coordinates\": [";
+    for (size_t r = 0; r < rings; ++r) {
+        out += r ? ", [" : "[";
+        for (size_t p = 0; p < points; ++p) {
+            std::snprintf(buffer, sizeof(buffer), "%s[%.15g, %.15g]", p ? ", " : "", lon(rng), lat(rng));
+            out += buffer;
+        }
+        out += "]";
+    }
+    return out + "]}}]}";
+}
+
+// 深层嵌套：对象与数组交替，接近默认深度上限
+std::string makeDeep(std::mt19937_64& rng, size_t depth) {
+    std::string out;
+    for (size_t d = 0; d < depth; ++d) {
+        out += d % 2 ? "[" + std::to_string(rng() % 100) + ", " : "{\"k" + std::to_string(d % 10) + "\": ";
+    }
+    out += "null";
+    for (size_t d = depth; d-- > 0;) {
+        out += d % 2 ? "]" : "}";
+    }
+    return out;
+}
+
+// 长字符串：多数为普通 ASCII，夹杂转义与多字节 UTF-8
+std::string makeLongStrings(std::mt19937_64& rng, size_t strings, size_t length) {
+    static const std::vector<std::string> pieces = {
+        "lorem ipsum dolor sit amet ", "consectetur adipiscing elit ", "\\n", "\\\"", "\\u00e9",
+        "\xe4\xb8\xad\xe6\x96\x87 ", "\\t", "sed do eiusmod tempor "};
+    std::string out = "{\"documents\": [";
+    for (size_t s = 0; s < strings; ++s) {
+        std::string text;
+        while (text.size() < length) {
+            text += rng() % 8 ? pieces[rng() % 2] + pieces[7] : pieces[rng() % pieces.size()];
+        }
+        out += (s ? ", " : "") + std::string("{\"id\": ") + std::to_string(s) + ", \"body\": \"" + text + "\"}";
+    }
+    return out + "]}";
+}
+
+// 大量小记录的 NDJSON
+std::string makeNdjson(std::mt19937_64& rng, size_t records) {
+    std::string out;
+    for (size_t i = 0; i < records; ++i) {
+        out += "{\"ts\": " + std::to_string(1700000000000 + i) + ", \"level\": \"" +
+               (rng() % 10 ? "info" : "error") + "\", \"msg\": \"request " + std::to_string(rng() % 100000) +
+               "\", \"status\": " + std::to_string(200 + rng() % 4 * 100) + ", \"ms\": " +
+               std::to_string((rng() % 100000) / 1000.0) + "}\n";
+    }
+    return out;
+}
+
+Corpus makeCorpus(const std::string& name, std::vector<std::string> documents) {
+    Corpus corpus;
+    corpus.name = name;
+    corpus.documents = std::move(documents);
+    for (const auto& document : corpus.documents) {
+        corpus.bytes += document.size();
+    }
+    return corpus;
+}
+
+std::vector<Corpus> makeCorpora(bool quick) {
+    std::mt19937_64 rng(20240601);
+    size_t scale = quick ? 1 : 8;
+    std::vector<Corpus> corpora;
+
+    std::vector<std::string> twitter;
+    for (size_t i = 0; i < scale; ++i) {
+        twitter.push_back(makeTwitter(rng, 100));
+    }
+    corpora.push_back(makeCorpus("twitter", std::move(twitter)));
+
+    corpora.push_back(makeCorpus("canada", {makeCanada(rng, 4 * scale, 5000)}));
+
+    std::vector<std::string> deep;
+    for (size_t i = 0; i < 16 * scale; ++i) {
+        deep.push_back(makeDeep(rng, 1000));
+    }
+    corpora.push_back(makeCorpus("deep", std::move(deep)));
+
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < scale; ++i) {
+        strings.push_back(makeLongStrings(rng, 16, 64 * 1024));
+    }
+    corpora.push_back(makeCorpus("long_strings", std::move(strings)));
+    return corpora;
+}
+
+// ---------------------------------------------------------------------------
+// 测量
+
+// 进程内存峰值（KB）；Linux 上每个基准开始前重置
+void resetPeakRss() {
+#ifdef __linux__
+    if (std::FILE* file = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", file);
+        std::fclose(file);
+    }
+#endif
+}
+
+size_t peakRssKb() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::strtoul(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return 0;
+#endif
+}
+
+Result measure(const Options& options, const std::string& name, size_t bytes, size_t documents,
+               const std::function<void()>& pass) {
+    pass();  // 预热：填充缓冲区和分配器缓存
+
+    resetPeakRss();
+    size_t allocationsBefore = g_allocations.load();
+    pass();
+    size_t allocations = g_allocations.load() - allocationsBefore;
+
+    std::vector<double> samples;
+    double total = 0;
+    while (samples.size() < options.minSamples || total < options.minTime) {
+        auto start = std::chrono::steady_clock::now();
+        pass();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double>(end - start).count());
+        total += samples.back();
+    }
+    std::sort(samples.begin(), samples.end());
+    double median = samples[samples.size() / 2];
+
+    Result result;
+    result.name = name;
+    result.bytes = bytes;
+    result.documents = documents;
+    result.seconds = median;
+    result.mbPerSecond = static_cast<double>(bytes) / (1024.0 * 1024.0) / median;
+    result.docsPerSecond = static_cast<double>(documents) / median;
+    result.allocsPerDoc = static_cast<double>(allocations) / static_cast<double>(documents);
+    result.peakRssKb = peakRssKb();
+    return result;
+}
+
+std::vector<Result> runAll(const Options& options) {
+    std::vector<Result> results;
+    auto selected = [&](const std::string& name) {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    };
+    auto report = [&](const Result& r) {
+        std::cout << std::left << std::setw(26) << r.name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(10) << r.mbPerSecond << std::setw(14)
+                  << r.docsPerSecond << std::setw(14) << std::setprecision(2) << r.allocsPerDoc
+                  << std::setw(12) << std::setprecision(1) << r.peakRssKb / 1024.0 << std::endl;
+        results.push_back(r);
+    };
+
+    std::cout << std::left << std::setw(26) << "benchmark" << std::right << std::setw(10) << "MB/s"
+              << std::setw(14) << "docs/s" << std::setw(14) << "allocs/doc" << std::setw(12)
+              << "peak MB" << std::endl;
+
+    size_t sink = 0;
+    for (const Corpus& corpus : makeCorpora(options.quick)) {
+        size_t count = corpus.documents.size();
+
+        // 解析为 JsonValue，复用同一个解析器
+        std::string name = "parse/" + corpus.name;
+        if (selected(name)) {
+            json::JsonParser parser;
+            report(measure(options, name, corpus.bytes, count, [&] {
+                for (const auto& document : corpus.documents) {
+                    sink += parser.parse(document).isObject();
+                }
+            }));
+        }
+
+        // 解析为 arena 文档，稳态下不再分配
+        name = "parse_document/" + corpus.name;
+        if (selected(name)) {
+            json::JsonParser parser;
+            json::Document doc;
+            report(measure(options, name, corpus.bytes, count, [&] {
+                for (const auto& document : corpus.documents) {
+                    parser.parse(document, doc);
+                    sink += doc.root().isObject();
+                }
+            }));
+        }
+
+        // 只校验不构造，不分配
+        name = "validate/" + corpus.name;
+        if (selected(name)) {
+            report(measure(options, name, corpus.bytes, count, [&] {
+                for (const auto& document : corpus.documents) {
+                    sink += json::validate(document).ok();
+                }
+            }));
+        }
+
+        // 序列化已解析的值，吞吐量按输入文本大小计
+        name = "serialize/" + corpus.name;
+        if (selected(name)) {
+            std::vector<json::JsonValue> values;
+            for (const auto& document : corpus.documents) {
+                values.push_back(json::JsonParser(document).parse());
+            }
+            std::string out;
+            report(measure(options, name, corpus.bytes, count, [&] {
+                for (const auto& value : values) {
+                    out.clear();
+                    json::JsonWriter writer(out);
+                    writer.write(value);
+                    sink += out.size();
+                }
+            }));
+        }
+
+        name = "roundtrip/" + corpus.name;
+        if (selected(name)) {
+            json::JsonParser parser;
+            report(measure(options, name, corpus.bytes, count, [&] {
+                for (const auto& document : corpus.documents) {
+                    sink += parser.parse(document).toString().size();
+                }
+            }));
+        }
+    }
+
+    std::mt19937_64 rng(7);
+    size_t records = options.quick ? 20000 : 200000;
+    std::string ndjson = makeNdjson(rng, records);
+    for (size_t threads : {size_t(1), size_t(0)}) {
+        std::string name = threads == 1 ? "ndjson/1_thread" : "ndjson/all_threads";
+        if (selected(name)) {
+            json::NdjsonOptions ndjsonOptions;
+            ndjsonOptions.threads = threads;
+            json::NdjsonReader reader(ndjsonOptions);
+            report(measure(options, name, ndjson.size(), records, [&] {
+                sink += reader.parse(ndjson).size();
+            }));
+        }
+    }
+
+    if (sink == 0) {
+        std::cerr << "no work done" << std::endl;
+    }
+    return results;
+}
+
+// ---------------------------------------------------------------------------
+// 机器可读输出与回归比较
+
+void writeResults(const std::string& path, const Options& options, const std::vector<Result>& results) {
+    std::string out;
+    json::WriterOptions pretty;
+    pretty.pretty = true;
+    {
+        json::JsonWriter writer(out, pretty);
+        writer.beginObject();
+        writer.key("version");
+        writer.integer(1);
+        writer.key("quick");
+        writer.boolean(options.quick);
+        writer.key("results");
+        writer.beginArray();
+        for (const Result& r : results) {
+            writer.beginObject();
+            writer.key("name");
+            writer.string(r.name);
+            writer.key("bytes");
+            writer.unsignedInteger(r.bytes);
+            writer.key("documents");
+            writer.unsignedInteger(r.documents);
+            writer.key("seconds");
+            writer.number(r.seconds);
+            writer.key("mb_per_s");
+            writer.number(r.mbPerSecond);
+            writer.key("docs_per_s");
+            writer.number(r.docsPerSecond);
+            writer.key("allocs_per_doc");
+            writer.number(r.allocsPerDoc);
+            writer.key("peak_rss_kb");
+            writer.unsignedInteger(r.peakRssKb);
+            writer.endObject();
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    std::ofstream file(path, std::ios::binary);
+    file << out << "\n";
+    if (!file) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+// 返回退化的基准数量
+size_t compareBaseline(const std::string& path, const Options& options, const std::vector<Result>& results) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot read " + path);
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    json::JsonValue baseline = json::JsonParser(text.str()).parse();
+
+    std::map<std::string, double> previous;
+    for (const auto& entry : baseline.asObject().at("results").asArray()) {
+        const auto& fields = entry.asObject();
+        previous[fields.at("name").asString()] = fields.at("mb_per_s").asNumber();
+    }
+
+    size_t regressions = 0;
+    std::cout << std::endl << "compared with " << path << " (threshold " << options.threshold << "%):" << std::endl;
+    for (const Result& r : results) {
+        auto it = previous.find(r.name);
+        if (it == previous.end() || it->second <= 0) {
+            continue;
+        }
+        double change = (r.mbPerSecond / it->second - 1.0) * 100.0;
+        bool regressed = change < -options.threshold;
+        regressions += regressed;
+        std::cout << std::left << std::setw(26) << r.name << std::right << std::showpos << std::fixed
+                  << std::setprecision(1) << std::setw(9) << change << "%" << std::noshowpos
+                  << (regressed ? "  REGRESSION" : "") << std::endl;
+    }
+    return regressions;
+}
+
+void usage() {
+    std::cout << "usage: jsonparser_bench [--quick] [--filter TEXT] [--min-time SECONDS]\n"
+                 "                        [--json FILE] [--baseline FILE] [--threshold PERCENT]\n"
+                 "Exits with status 2 if a benchmark is slower than the baseline by more\n"
+                 "than the threshold.\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--quick") {
+            options.quick = true;
+            options.minTime = 0.1;
+            options.minSamples = 3;
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time" && hasValue) {
+            options.minTime = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--baseline" && hasValue) {
+            options.baselinePath = argv[++i];
+        } else if (arg == "--threshold" && hasValue) {
+            options.threshold = std::strtod(argv[++i], nullptr);
+        } else {
+            usage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    try {
+        std::vector<Result> results = runAll(options);
+        if (!options.jsonPath.empty()) {
+            writeResults(options.jsonPath, options, results);
+        }
+        if (!options.baselinePath.empty() && compareBaseline(options.baselinePath, options, results) > 0) {
+            return 2;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
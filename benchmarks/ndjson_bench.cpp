@@ -0,0 +1,64 @@
+#include "json_ndjson.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+// 类似访问日志的记录
+std::string makeLog(size_t records) {
+    std::mt19937_64 rng(42);
+    std::string out;
+    for (size_t i = 0; i < records; ++i) {
+        out += "{\"ts\": " + std::to_string(1700000000000 + i) +
+               ", \"level\": \"" + (rng() % 10 ? "info" : "error") +
+               "\", \"path\": \"/api/v1/items/" + std::to_string(rng() % 100000) +
+               "\", \"status\": " + std::to_string(200 + rng() % 4 * 100) +
+               ", \"latency\": " + std::to_string((rng() % 100000) / 1000.0) +
+               ", \"tags\": [\"web\", \"eu-west\", \"canary\"], \"user\": {\"id\": " +
+               std::to_string(rng() % 1000000) + ", \"agent\": \"Mozilla/5.0\"}}\n";
+    }
+    return out;
+}
+
+int main(int argc, char** argv) {
+    size_t records = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t maxThreads = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                 : std::max(1u, std::thread::hardware_concurrency());
+
+    std::string input = makeLog(records);
+    double megabytes = static_cast<double>(input.size()) / (1024.0 * 1024.0);
+    std::cout << "input:              " << records << " records, "
+              << std::fixed << std::setprecision(1) << megabytes << " MB" << std::endl;
+
+    double baseline = 0;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        json::NdjsonOptions options;
+        options.threads = threads;
+        json::NdjsonReader reader(options);
+
+        // 有序模式
+        auto start = std::chrono::steady_clock::now();
+        size_t parsed = reader.parse(input).size();
+        auto end = std::chrono::steady_clock::now();
+        double ordered = megabytes / std::chrono::duration<double>(end - start).count();
+
+        // 无序回调模式
+        start = std::chrono::steady_clock::now();
+        reader.parseUnordered(input, [](json::NdjsonRecord&&) {});
+        end = std::chrono::steady_clock::now();
+        double unordered = megabytes / std::chrono::duration<double>(end - start).count();
+
+        if (threads == 1) {
+            baseline = ordered;
+        }
+        std::cout << "threads " << std::setw(3) << threads << ":        "
+                  << std::setprecision(1) << ordered << " MB/s ordered, "
+                  << unordered << " MB/s unordered, " << parsed << " records, "
+                  << std::setprecision(2) << ordered / baseline << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "json_number.h"
+#include "json_parser.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 旧实现：每个数字构造一个stringstream，固定6位小数后去掉尾零
+std::string legacyFormat(double value) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(6) << value;
+    std::string str = ss.str();
+    str.erase(str.find_last_not_of('0') + 1, std::string::npos);
+    if (str.back() == '.') {
+        str.pop_back();
+    }
+    return str;
+}
+
+template <typename Format>
+double measure(const std::vector<double>& numbers, Format format, size_t& bytes) {
+    auto start = std::chrono::steady_clock::now();
+    bytes = 0;
+    for (double value : numbers) {
+        bytes += format(value);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return static_cast<double>(numbers.size()) / seconds;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    // 类似坐标数组的浮点数据
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> coordinate(-180.0, 180.0);
+    std::vector<double> numbers(count);
+    for (double& value : numbers) {
+        value = coordinate(rng);
+    }
+
+    size_t legacyBytes = 0;
+    double legacyRate = measure(numbers, [](double v) { return legacyFormat(v).size(); }, legacyBytes);
+
+    size_t shortestBytes = 0;
+    char buffer[json::kMaxNumberLength];
+    double shortestRate = measure(numbers, [&](double v) { return json::formatNumber(v, buffer); }, shortestBytes);
+
+    // 往返校验：旧实现丢失精度，新实现逐位一致
+    size_t legacyExact = 0;
+    size_t shortestExact = 0;
+    for (double value : numbers) {
+        if (std::strtod(legacyFormat(value).c_str(), nullptr) == value) {
+            legacyExact++;
+        }
+        size_t length = json::formatNumber(value, buffer);
+        if (json::parseNumber(std::string_view(buffer, length)).d == value) {
+            shortestExact++;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "numbers:            " << count << std::endl;
+    std::cout << "stringstream:       " << legacyRate << " numbers/s, "
+              << legacyBytes << " bytes, " << legacyExact << " exact round trips" << std::endl;
+    std::cout << "formatNumber:       " << shortestRate << " numbers/s, "
+              << shortestBytes << " bytes, " << shortestExact << " exact round trips" << std::endl;
+    std::cout << std::setprecision(2);
+    std::cout << "speedup:            " << shortestRate / legacyRate << "x" << std::endl;
+    return 0;
+}
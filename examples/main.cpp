@@ -1,4 +1,5 @@
 #include "json_parser.h"
+#include "json_query.h"
 #include <iostream>
 
 int main() {
@@ -63,6 +64,19 @@ int main() {
             std::cout << std::endl;
         }
 
+        // Test path queries
+        {
+            std::cout << std::endl << "Test path queries:" << std::endl;
+            json::JsonQuery query = {
+                json::JsonPath::fromPointer("/person/address/city"),
+                json::JsonPath::fromJsonPath("$.person.hobbies[*]"),
+            };
+            auto result = query.scan(R"({"person": {"address": {"city": "Beijing"}, "hobbies": ["Reading", "Sports"]}})");
+
+            std::cout << "City: " << result[0][0].asString() << std::endl;
+            std::cout << "Hobbies: " << result[1].size() << std::endl;
+        }
+
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
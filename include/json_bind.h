@@ -0,0 +1,473 @@
+#pragma once
+
+#include "json_lexer.h"
+#include "json_number.h"
+#include "json_parser.h"
+#include "json_value.h"
+#include "json_writer.h"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace json {
+
+// Struct binding
+//
+// A struct is bound by listing its members once, next to the struct (in the
+// same namespace, so argument-dependent lookup finds it):
+//
+//     struct Person { std::string name; int age; std::vector<std::string> tags; };
+//     JSON_BIND(Person, name, age, tags)
+//
+// or, to use JSON names that differ from the member names:
+//
+//     constexpr auto jsonBinding(const Person*) {
+//         return std::make_tuple(json::field("full_name", &Person::name),
+//                                json::field("age", &Person::age));
+//     }
+//
+// decode<Person>(text) then reads tokens straight from the lexer into the
+// struct, without building a JsonValue. Keys are looked up in a perfect
+// hash table computed at compile time from the field names, and each field
+// is read by a decoder specialized for its type. Unknown keys are skipped,
+// missing fields keep their current value, and with duplicate keys the last
+// one wins. encode() writes the fields back in declaration order.
+//
+// Supported member types are bool, arithmetic types, std::string,
+// std::optional, std::vector, JsonValue and other bound structs. Other types
+// can be supported by specializing Codec.
+
+// One bound member
+template <typename Class, typename Member>
+struct Field {
+    std::string_view name;
+    Member Class::*member;
+};
+
+template <typename Class, typename Member>
+constexpr Field<Class, Member> field(std::string_view name, Member Class::*member) {
+    return Field<Class, Member>{name, member};
+}
+
+// Token-level reader used by the decoders
+//
+// Wraps a sequential JsonLexer and reports errors with the same messages
+// and locations as JsonParser.
+class BindReader {
+public:
+    BindReader(std::string_view input, const ParseOptions& options);
+
+    BindReader(const BindReader&) = delete;
+    BindReader& operator=(const BindReader&) = delete;
+
+    TokenType type() const { return current_.type; }
+    void advance() { current_ = lexer_.nextToken(); }
+
+    // Throw ParserError located at the current token
+    [[noreturn]] void fail(std::string_view message) const;
+
+    // Fail with `expected`, or with the lexer's message on a malformed token
+    [[noreturn]] void unexpected(const char* expected) const;
+
+    // Consume null if it is next
+    bool readNull();
+
+    bool readBoolean();
+
+    // Decode the current NUMBER token without consuming it, so range errors
+    // can still point at it
+    NumberValue number() const;
+
+    // Decoded string; valid until the next string is read
+    std::string_view readString();
+
+    // Object members: call nextMember() until it returns false. `count` starts
+    // at 0 and tracks the members read so far.
+    void beginObject();
+    bool nextMember(size_t& count, std::string_view& key);
+
+    // Array elements, likewise
+    void beginArray();
+    bool nextElement(size_t& count);
+
+    // Skip any value (iteratively, whatever its depth)
+    void skipValue();
+
+    // Parse the next value into a JsonValue
+    JsonValue readValue();
+
+    // Check that the input ends after the top-level value
+    void finish();
+
+private:
+    struct SkipFrame {
+        bool isObject;
+        size_t count;
+    };
+
+    std::string_view input_;
+    JsonLexer lexer_;
+    Token current_;
+    std::string scratch_;
+    size_t depth_ = 0;
+    ParseOptions options_;
+    std::vector<SkipFrame> skipStack_;
+
+    void enter();
+};
+
+// Reads and writes values of type V; specialize to support more types
+template <typename V, typename Enable = void>
+struct Codec;
+
+namespace detail {
+
+template <typename T, typename = void>
+struct IsBound : std::false_type {};
+template <typename T>
+struct IsBound<T, std::void_t<decltype(jsonBinding(static_cast<const T*>(nullptr)))>> : std::true_type {};
+
+// FNV-1a with a seed chosen per struct
+constexpr uint32_t hashKey(std::string_view key, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+constexpr size_t hashSlots(size_t count) {
+    size_t slots = 1;
+    while (slots < count * 4) {
+        slots *= 2;
+    }
+    return slots;
+}
+
+// Collision-free table from key hash to field index
+template <size_t N>
+struct PerfectHash {
+    static constexpr size_t kSlots = hashSlots(N);
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    uint32_t seed = 0;
+    std::array<uint8_t, kSlots> slots{};  // Field index + 1, 0 if empty
+
+    size_t find(std::string_view key, const std::array<std::string_view, N>& names) const {
+        size_t slot = slots[hashKey(key, seed) & (kSlots - 1)];
+        return slot != 0 && names[slot - 1] == key ? slot - 1 : npos;
+    }
+};
+
+template <size_t N>
+constexpr bool hasDuplicates(const std::array<std::string_view, N>& names) {
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = i + 1; j < N; ++j) {
+            if (names[i] == names[j]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <size_t N>
+constexpr PerfectHash<N> buildPerfectHash(const std::array<std::string_view, N>& names) {
+    // Try seeds until every key lands in its own slot
+    PerfectHash<N> table;
+    for (uint32_t seed = 0;; ++seed) {
+        table.seed = seed;
+        table.slots = {};
+        bool collision = false;
+        for (size_t i = 0; i < N && !collision; ++i) {
+            size_t slot = hashKey(names[i], seed) & (PerfectHash<N>::kSlots - 1);
+            collision = table.slots[slot] != 0;
+            table.slots[slot] = static_cast<uint8_t>(i + 1);
+        }
+        if (!collision) {
+            return table;
+        }
+    }
+}
+
+template <typename Fields, size_t... I>
+constexpr std::array<std::string_view, sizeof...(I)> fieldNames(const Fields& fields, std::index_sequence<I...>) {
+    return {{std::get<I>(fields).name...}};
+}
+
+template <typename T>
+struct Binding {
+    static constexpr auto fields = jsonBinding(static_cast<const T*>(nullptr));
+    static constexpr size_t kCount = std::tuple_size<std::decay_t<decltype(fields)>>::value;
+    // The seed search in buildPerfectHash() needs about e^(N/8) tries, which
+    // stays well within constexpr evaluation limits up to JSON_BIND's 32
+    static_assert(kCount > 0 && kCount <= 32, "a bound struct needs 1 to 32 fields");
+
+    static constexpr std::array<std::string_view, kCount> names =
+        fieldNames(fields, std::make_index_sequence<kCount>());
+    static_assert(!hasDuplicates(names), "duplicate JSON field name");
+    static constexpr PerfectHash<kCount> hash = buildPerfectHash(names);
+
+    using Reader = void (*)(BindReader&, T&);
+
+    template <size_t I>
+    static void readField(BindReader& reader, T& value) {
+        auto& member = value.*(std::get<I>(fields).member);
+        Codec<std::decay_t<decltype(member)>>::read(reader, member);
+    }
+
+    template <size_t... I>
+    static constexpr std::array<Reader, kCount> makeReaders(std::index_sequence<I...>) {
+        return {{&readField<I>...}};
+    }
+
+    static constexpr std::array<Reader, kCount> readers = makeReaders(std::make_index_sequence<kCount>());
+};
+
+} // namespace detail
+
+template <>
+struct Codec<bool> {
+    static void read(BindReader& reader, bool& value) { value = reader.readBoolean(); }
+    static void write(JsonWriter& writer, bool value) { writer.boolean(value); }
+};
+
+template <typename V>
+struct Codec<V, std::enable_if_t<std::is_integral_v<V> && !std::is_same_v<V, bool>>> {
+    static void read(BindReader& reader, V& value) {
+        if (reader.type() != TokenType::NUMBER) {
+            reader.unexpected("Expected integer");
+        }
+        NumberValue number = reader.number();
+        if (number.kind == NumberValue::Kind::Double) {
+            reader.fail("Expected integer");
+        }
+        bool inRange;
+        if (number.kind == NumberValue::Kind::Int64) {
+            inRange = std::is_signed_v<V> ? number.i >= static_cast<int64_t>(std::numeric_limits<V>::min()) &&
+                                                number.i <= static_cast<int64_t>(std::numeric_limits<V>::max())
+                                          : number.i >= 0 &&
+                                                static_cast<uint64_t>(number.i) <= std::numeric_limits<V>::max();
+            value = static_cast<V>(number.i);
+        } else {
+            inRange = number.u <= static_cast<uint64_t>(std::numeric_limits<V>::max());
+            value = static_cast<V>(number.u);
+        }
+        if (!inRange) {
+            reader.fail("Integer out of range");
+        }
+        reader.advance();
+    }
+
+    static void write(JsonWriter& writer, V value) {
+        if constexpr (std::is_signed_v<V>) {
+            writer.integer(static_cast<int64_t>(value));
+        } else {
+            writer.unsignedInteger(static_cast<uint64_t>(value));
+        }
+    }
+};
+
+template <typename V>
+struct Codec<V, std::enable_if_t<std::is_floating_point_v<V>>> {
+    static void read(BindReader& reader, V& value) {
+        if (reader.type() != TokenType::NUMBER) {
+            reader.unexpected("Expected number");
+        }
+        NumberValue number = reader.number();
+        switch (number.kind) {
+            case NumberValue::Kind::Int64:
+                value = static_cast<V>(number.i);
+                break;
+            case NumberValue::Kind::UInt64:
+                value = static_cast<V>(number.u);
+                break;
+            default:
+                value = static_cast<V>(number.d);
+                break;
+        }
+        reader.advance();
+    }
+
+    static void write(JsonWriter& writer, V value) { writer.number(static_cast<double>(value)); }
+};
+
+template <>
+struct Codec<std::string> {
+    static void read(BindReader& reader, std::string& value) {
+        std::string_view text = reader.readString();
+        value.assign(text.data(), text.size());
+    }
+    static void write(JsonWriter& writer, const std::string& value) { writer.string(value); }
+};
+
+template <>
+struct Codec<JsonValue> {
+    static void read(BindReader& reader, JsonValue& value) { value = reader.readValue(); }
+    static void write(JsonWriter& writer, const JsonValue& value) { writer.write(value); }
+};
+
+// null maps to an empty optional
+template <typename U>
+struct Codec<std::optional<U>> {
+    static void read(BindReader& reader, std::optional<U>& value) {
+        if (reader.readNull()) {
+            value.reset();
+            return;
+        }
+        if (!value) {
+            value.emplace();
+        }
+        Codec<U>::read(reader, *value);
+    }
+
+    static void write(JsonWriter& writer, const std::optional<U>& value) {
+        if (value) {
+            Codec<U>::write(writer, *value);
+        } else {
+            writer.null();
+        }
+    }
+};
+
+template <typename U, typename Allocator>
+struct Codec<std::vector<U, Allocator>> {
+    static void read(BindReader& reader, std::vector<U, Allocator>& value) {
+        value.clear();
+        reader.beginArray();
+        size_t count = 0;
+        while (reader.nextElement(count)) {
+            U element{};
+            Codec<U>::read(reader, element);
+            value.push_back(std::move(element));
+        }
+    }
+
+    static void write(JsonWriter& writer, const std::vector<U, Allocator>& value) {
+        writer.beginArray();
+        for (const auto& element : value) {
+            Codec<U>::write(writer, element);
+        }
+        writer.endArray();
+    }
+};
+
+template <typename T>
+struct Codec<T, std::enable_if_t<detail::IsBound<T>::value>> {
+    using Binding = detail::Binding<T>;
+
+    static void read(BindReader& reader, T& value) {
+        reader.beginObject();
+        size_t count = 0;
+        std::string_view key;
+        while (reader.nextMember(count, key)) {
+            size_t index = Binding::hash.find(key, Binding::names);
+            if (index == detail::PerfectHash<Binding::kCount>::npos) {
+                reader.skipValue();
+            } else {
+                Binding::readers[index](reader, value);
+            }
+        }
+    }
+
+    static void write(JsonWriter& writer, const T& value) {
+        writer.beginObject();
+        std::apply([&](const auto&... fields) {
+            (writeField(writer, fields.name, value.*(fields.member)), ...);
+        }, Binding::fields);
+        writer.endObject();
+    }
+
+private:
+    template <typename Member>
+    static void writeField(JsonWriter& writer, std::string_view name, const Member& member) {
+        writer.key(name);
+        Codec<Member>::write(writer, member);
+    }
+};
+
+// Decode `input` into an existing value (containers are cleared first and
+// keep their capacity)
+template <typename T>
+void decode(std::string_view input, T& value, const ParseOptions& options = ParseOptions()) {
+    BindReader reader(input, options);
+    Codec<T>::read(reader, value);
+    reader.finish();
+}
+
+template <typename T>
+T decode(std::string_view input, const ParseOptions& options = ParseOptions()) {
+    T value{};
+    decode(input, value, options);
+    return value;
+}
+
+template <typename T>
+void encode(JsonWriter& writer, const T& value) {
+    Codec<T>::write(writer, value);
+}
+
+template <typename T>
+std::string encode(const T& value, const WriterOptions& options = WriterOptions()) {
+    std::string out;
+    JsonWriter writer(out, options);
+    Codec<T>::write(writer, value);
+    return out;
+}
+
+} // namespace json
+
+// JSON_BIND(Type, member...) binds up to 32 members under their own names.
+// Use it in the namespace that declares Type.
+#define JSON_BIND(Type, ...)                                                      \
+    [[maybe_unused]] constexpr auto jsonBinding(const Type*) {                    \
+        return std::make_tuple(JSON_BIND_EXPAND(                                  \
+            JSON_BIND_CAT(JSON_BIND_, JSON_BIND_COUNT(__VA_ARGS__))(Type, __VA_ARGS__))); \
+    }
+
+#define JSON_BIND_EXPAND(x) x
+#define JSON_BIND_CAT(a, b) JSON_BIND_CAT_(a, b)
+#define JSON_BIND_CAT_(a, b) a##b
+#define JSON_BIND_FIELD(Type, member) ::json::field(#member, &Type::member)
+#define JSON_BIND_1(Type, m) JSON_BIND_FIELD(Type, m)
+#define JSON_BIND_2(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_1(Type, __VA_ARGS__))
+#define JSON_BIND_3(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_2(Type, __VA_ARGS__))
+#define JSON_BIND_4(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_3(Type, __VA_ARGS__))
+#define JSON_BIND_5(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_4(Type, __VA_ARGS__))
+#define JSON_BIND_6(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_5(Type, __VA_ARGS__))
+#define JSON_BIND_7(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_6(Type, __VA_ARGS__))
+#define JSON_BIND_8(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_7(Type, __VA_ARGS__))
+#define JSON_BIND_9(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_8(Type, __VA_ARGS__))
+#define JSON_BIND_10(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_9(Type, __VA_ARGS__))
+#define JSON_BIND_11(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_10(Type, __VA_ARGS__))
+#define JSON_BIND_12(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_11(Type, __VA_ARGS__))
+#define JSON_BIND_13(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_12(Type, __VA_ARGS__))
+#define JSON_BIND_14(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_13(Type, __VA_ARGS__))
+#define JSON_BIND_15(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_14(Type, __VA_ARGS__))
+#define JSON_BIND_16(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_15(Type, __VA_ARGS__))
+#define JSON_BIND_17(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_16(Type, __VA_ARGS__))
+#define JSON_BIND_18(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_17(Type, __VA_ARGS__))
+#define JSON_BIND_19(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_18(Type, __VA_ARGS__))
+#define JSON_BIND_20(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_19(Type, __VA_ARGS__))
+#define JSON_BIND_21(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_20(Type, __VA_ARGS__))
+#define JSON_BIND_22(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_21(Type, __VA_ARGS__))
+#define JSON_BIND_23(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_22(Type, __VA_ARGS__))
+#define JSON_BIND_24(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_23(Type, __VA_ARGS__))
+#define JSON_BIND_25(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_24(Type, __VA_ARGS__))
+#define JSON_BIND_26(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_25(Type, __VA_ARGS__))
+#define JSON_BIND_27(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_26(Type, __VA_ARGS__))
+#define JSON_BIND_28(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_27(Type, __VA_ARGS__))
+#define JSON_BIND_29(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_28(Type, __VA_ARGS__))
+#define JSON_BIND_30(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_29(Type, __VA_ARGS__))
+#define JSON_BIND_31(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_30(Type, __VA_ARGS__))
+#define JSON_BIND_32(Type, m, ...) JSON_BIND_FIELD(Type, m), JSON_BIND_EXPAND(JSON_BIND_31(Type, __VA_ARGS__))
+#define JSON_BIND_COUNT(...) JSON_BIND_EXPAND(JSON_BIND_COUNT_(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define JSON_BIND_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "json_value.h"
+#include "json_parser.h"
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+// Malformed or unsupported CBOR input
+class CborError : public std::runtime_error {
+public:
+    explicit CborError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+// CBOR (RFC 8949) encoding of JsonValue
+//
+// Every container is written with a definite length, so a decoder can size
+// Array/Object up front and skip a subtree by reading item headers only,
+// jumping over string bytes instead of scanning them. The mapping keeps the
+// JsonValue alternative intact across a round trip:
+//   null, true, false   simple values 22, 21, 20
+//   Integer, Unsigned   major types 0 and 1
+//   Number              float32 when exact, float64 otherwise
+//   String              text string (major type 3)
+//   Array, Object       array / map (major types 4 and 5), keys are text
+//
+// Decoding also accepts float16, "undefined" (read as null) and tags (the
+// tagged item is decoded, the tag ignored). Byte strings, indefinite
+// lengths and non-text map keys are rejected. Negative integers below
+// INT64_MIN decode to Number. Neither direction recurses.
+
+// Append the encoding of `value` to `out`
+void writeCbor(const JsonValue& value, std::string& out);
+std::string toCbor(const JsonValue& value);
+
+// Decode exactly one item; throws CborError. options.maxDepth limits nesting
+// and options.validateUtf8 checks text strings.
+JsonValue parseCbor(std::string_view data, const ParseOptions& options = ParseOptions());
+
+// Offset just past the item that starts at `offset`; throws CborError if it
+// is truncated
+size_t skipCbor(std::string_view data, size_t offset = 0);
+
+} // namespace json
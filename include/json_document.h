@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "json_keys.h"
+#include "json_parser.h"
+#include "json_sax.h"
+
+namespace json {
+
+// Bump allocator
+//
+// Memory is handed out from large blocks and is only released all at once,
+// when the arena is reset or destroyed. Nothing allocated from an arena has
+// its destructor run.
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 64 * 1024);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    // The moved-from arena is left empty, as after release()
+    Arena(Arena&& other) noexcept;
+    Arena& operator=(Arena&& other) noexcept;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Copy a string into the arena
+    std::string_view copyString(std::string_view str);
+
+    // Discard every allocation but keep the blocks, so a document of similar
+    // size can be rebuilt without touching the system allocator
+    void reset();
+
+    // Discard every allocation and free the blocks
+    void release();
+
+    // Total bytes handed out / reserved from the system
+    size_t bytesUsed() const { return used_; }
+    size_t bytesReserved() const { return reserved_; }
+
+    // Blocks obtained from the system so far
+    size_t blockCount() const { return blocks_.size(); }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t current_;  // Index of the block being filled
+    size_t blockSize_;
+    char* cursor_;
+    char* limit_;
+    size_t used_;
+    size_t reserved_;
+
+    void grow(size_t minSize);
+};
+
+class DocObject;
+class DocArray;
+struct DocMember;
+
+// Document value
+//
+// A 16-byte tagged union: one byte of type tag, a 32-bit length for strings
+// and containers, and an 8-byte payload. Strings and container elements live
+// in the owning Document's arena; objects are contiguous key/value arrays in
+// document order.
+class DocValue {
+public:
+    enum class Type : uint8_t { Null, Boolean, Number, String, Array, Object, Integer, Unsigned };
+
+    DocValue() : type_(Type::Null), size_(0) { payload_.number = 0; }
+
+    Type type() const { return type_; }
+
+    // Type checks
+    bool isObject() const { return type_ == Type::Object; }
+    bool isArray() const { return type_ == Type::Array; }
+    bool isString() const { return type_ == Type::String; }
+    bool isNumber() const { return type_ == Type::Number || isInt(); }
+    bool isDouble() const { return type_ == Type::Number; }
+    bool isInt() const { return type_ == Type::Integer || type_ == Type::Unsigned; }
+    bool isBoolean() const { return type_ == Type::Boolean; }
+    bool isNull() const { return type_ == Type::Null; }
+
+    // Get value; throws std::bad_variant_access on a type mismatch, like JsonValue
+    DocObject asObject() const;
+    DocArray asArray() const;
+    std::string_view asString() const;
+    double asNumber() const;
+    int64_t asInt64() const;
+    uint64_t asUint64() const;
+    bool asBoolean() const;
+
+    // Construction (used while building a document)
+    static DocValue makeNull() { return DocValue(); }
+    static DocValue makeBoolean(bool b);
+    static DocValue makeNumber(double n);
+    static DocValue makeInteger(int64_t n);
+    static DocValue makeUnsigned(uint64_t n);
+    static DocValue makeString(std::string_view str);
+    static DocValue makeArray(const DocValue* elements, size_t count);
+    static DocValue makeObject(const DocMember* members, size_t count);
+
+private:
+    Type type_;
+    uint32_t size_;
+    union {
+        bool boolean;
+        double number;
+        int64_t integer;
+        uint64_t uinteger;
+        const char* string;
+        const DocValue* elements;
+        const DocMember* members;
+    } payload_;
+
+    void expect(Type type) const;
+};
+
+static_assert(sizeof(DocValue) == 16, "DocValue must stay a 16-byte tagged union");
+
+// Object member
+struct DocMember {
+    std::string_view key;
+    DocValue value;
+};
+
+// Read-only view of an array
+class DocArray {
+public:
+    DocArray(const DocValue* elements, size_t size) : elements_(elements), size_(size) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const DocValue& operator[](size_t i) const { return elements_[i]; }
+    const DocValue& at(size_t i) const;
+
+    const DocValue* begin() const { return elements_; }
+    const DocValue* end() const { return elements_ + size_; }
+
+private:
+    const DocValue* elements_;
+    size_t size_;
+};
+
+// Read-only view of an object, members in document order
+class DocObject {
+public:
+    DocObject(const DocMember* members, size_t size) : members_(members), size_(size) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Lookup by key; at() throws std::out_of_range like std::map::at. A
+    // repeated key keeps every member, but lookups return the last one, the
+    // value JsonParser::parse() keeps.
+    const DocValue& at(std::string_view key) const;
+    const DocValue* find(std::string_view key) const;
+
+    // Lookup by handle, comparing key pointers only; the document must have
+    // been parsed with the KeyTable that issued `key`. A null handle (a key
+    // the table does not hold) finds nothing.
+    const DocValue* find(InternedKey key) const;
+    size_t count(std::string_view key) const { return find(key) ? 1 : 0; }
+
+    const DocMember* begin() const { return members_; }
+    const DocMember* end() const { return members_ + size_; }
+
+private:
+    const DocMember* members_;
+    size_t size_;
+};
+
+// Arena-allocated JSON document
+//
+// Every node, key and string of the document is allocated from a single
+// arena, so tearing down a document frees a handful of blocks instead of
+// one allocation per node.
+class Document {
+public:
+    Document() = default;
+
+    // Parse `input` into a new document; throws ParserError like JsonParser
+    static Document parse(std::string_view input, const ParseOptions& options = ParseOptions());
+
+    // Like parse(), but strings and keys without escapes point straight into
+    // `input` instead of being copied; `input` must outlive the document
+    static Document parseBorrowed(std::string_view input,
+                                  const ParseOptions& options = ParseOptions());
+
+    const DocValue& root() const { return root_; }
+    const Arena& arena() const { return arena_; }
+
+private:
+    friend class JsonParser;
+
+    Arena arena_;
+    DocValue root_;
+};
+
+// SAX handler that builds a document. Children of open containers are
+// collected on scratch stacks and copied into the arena as one contiguous
+// block when the container closes.
+class DocumentBuilder final : public SaxHandler {
+public:
+    // Strings that lie inside `source` are referenced instead of copied;
+    // keys go to `keys` when given
+    explicit DocumentBuilder(Arena& arena, std::string_view source = std::string_view(),
+                             KeyTable* keys = nullptr)
+        : arena_(&arena), source_(source), keys_(keys) {}
+
+    // Build the next document into `arena`, keeping the scratch stacks
+    void reset(Arena& arena, std::string_view source = std::string_view(),
+               KeyTable* keys = nullptr) {
+        arena_ = &arena;
+        source_ = source;
+        keys_ = keys;
+        frames_.clear();
+        elements_.clear();
+        members_.clear();
+        root_ = DocValue();
+    }
+
+    bool onNull() override { return emit(DocValue::makeNull()); }
+    bool onBoolean(bool b) override { return emit(DocValue::makeBoolean(b)); }
+    bool onNumber(double n) override { return emit(DocValue::makeNumber(n)); }
+    bool onInteger(int64_t n) override { return emit(DocValue::makeInteger(n)); }
+    bool onUnsigned(uint64_t n) override { return emit(DocValue::makeUnsigned(n)); }
+    bool onString(std::string_view s) override { return emit(DocValue::makeString(store(s))); }
+
+    bool onKey(std::string_view key) override {
+        InternedKey interned = keys_ ? keys_->intern(key) : InternedKey();
+        frames_.back().key = interned ? interned.view() : store(key);
+        return true;
+    }
+
+    bool onStartObject() override {
+        frames_.push_back(Frame{true, {}});
+        return true;
+    }
+
+    bool onEndObject(size_t count) override {
+        frames_.pop_back();
+        DocMember* block = count ? arena_->allocateArray<DocMember>(count) : nullptr;
+        std::copy(members_.end() - static_cast<std::ptrdiff_t>(count), members_.end(), block);
+        members_.resize(members_.size() - count);
+        return emit(DocValue::makeObject(block, count));
+    }
+
+    bool onStartArray() override {
+        frames_.push_back(Frame{false, {}});
+        return true;
+    }
+
+    bool onEndArray(size_t count) override {
+        frames_.pop_back();
+        DocValue* block = count ? arena_->allocateArray<DocValue>(count) : nullptr;
+        std::copy(elements_.end() - static_cast<std::ptrdiff_t>(count), elements_.end(), block);
+        elements_.resize(elements_.size() - count);
+        return emit(DocValue::makeArray(block, count));
+    }
+
+    DocValue root() const { return root_; }
+
+private:
+    struct Frame {
+        bool isObject;
+        std::string_view key;
+    };
+
+    Arena* arena_;
+    std::string_view source_;
+    KeyTable* keys_;
+    std::vector<Frame> frames_;
+    std::vector<DocValue> elements_;
+    std::vector<DocMember> members_;
+    DocValue root_;
+
+    std::string_view store(std::string_view s) {
+        // 未转义的字符串直接指向输入，解码后的字符串位于解析器的临时缓冲区中，需要复制
+        std::less_equal<const char*> notAfter;
+        if (!source_.empty() && notAfter(source_.data(), s.data()) &&
+            notAfter(s.data() + s.size(), source_.data() + source_.size())) {
+            return s;
+        }
+        return arena_->copyString(s);
+    }
+
+    bool emit(DocValue value) {
+        if (frames_.empty()) {
+            root_ = value;
+        } else if (frames_.back().isObject) {
+            members_.push_back(DocMember{frames_.back().key, value});
+        } else {
+            elements_.push_back(value);
+        }
+        return true;
+    }
+};
+
+} // namespace json
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "json_document.h"
+#include "json_parser.h"
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+// File access exception
+class FileError : public std::runtime_error {
+public:
+    explicit FileError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+// Read-only memory mapping of a whole file
+//
+// The file is mapped with a sequential-access hint so the kernel reads ahead
+// while the lexer streams through it. Nothing past size() is ever read: the
+// structural index copies the final partial block into its own padded
+// buffer, so no padding is needed after the last page. Empty files map to
+// an empty view. On platforms without mmap the file is read into memory.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+    void release();
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;  // false: data_ is a heap copy (or null)
+};
+
+// Map `path` and parse it into a JsonValue; the mapping is released before
+// returning. Throws FileError or ParserError.
+JsonValue parseFile(const std::string& path, const ParseOptions& options = ParseOptions());
+
+// Document parsed straight from a mapped file
+//
+// String values and keys without escapes point into the mapping, which
+// stays open for as long as the document lives; only escaped strings are
+// copied into the arena.
+class MappedDocument {
+public:
+    explicit MappedDocument(const std::string& path, const ParseOptions& options = ParseOptions());
+
+    const DocValue& root() const { return document_.root(); }
+    const Document& document() const { return document_; }
+    std::string_view source() const { return file_.view(); }
+
+private:
+    MappedFile file_;      // Declared first so it outlives document_
+    Document document_;
+};
+
+} // namespace json
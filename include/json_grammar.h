@@ -0,0 +1,145 @@
+#pragma once
+
+#include "json_lexer.h"
+#include <cstddef>
+
+namespace json {
+
+// What the grammar expected where it found something else
+enum class GrammarError {
+    ExpectedValue,      // Includes an ERROR token where a value should start
+    ExpectedKey,
+    ExpectedColon,
+    ExpectedObjectEnd,  // ',' or '}'
+    ExpectedArrayEnd,   // ',' or ']'
+    ExpectedMemberEnd   // ',' or end of input, after a member of the base container
+};
+
+namespace detail {
+
+// The JSON grammar shared by SaxReader and validate()
+//
+// A loop over the caller's stack of open containers; `Actions` supplies the
+// tokens, the stack and what to do with each value:
+//
+//   const Token& token() const          Current token
+//   bool advance()                      Move to the next token
+//   size_t depth() const                Open containers
+//   bool topIsObject() const            Kind of the innermost one
+//   bool startContainer(bool isObject)  At '{' or '[', before advancing
+//   bool push(bool isObject)            A non-empty container opens
+//   size_t pop()                        Close the innermost container and
+//                                       return the members it started
+//   bool endContainer(bool isObject, size_t count)  After the closing bracket
+//   bool member()                       A member starts in the innermost container
+//   bool key(), string(), number(), boolean(bool), null()
+//                                       Consume the current token as that value
+//   bool fail(GrammarError)             Report a grammar error
+//
+// Every hook returns false to stop, which makes the grammar return false.
+
+// Start the next member of the innermost container: its key and colon for an object
+template <typename Actions>
+bool parseMemberStart(Actions& actions) {
+    if (!actions.member()) {
+        return false;
+    }
+    if (!actions.topIsObject()) {
+        return true;
+    }
+    if (actions.token().type != TokenType::STRING) {
+        return actions.fail(GrammarError::ExpectedKey);
+    }
+    if (!actions.key()) {
+        return false;
+    }
+    if (actions.token().type != TokenType::COLON) {
+        return actions.fail(GrammarError::ExpectedColon);
+    }
+    return actions.advance();
+}
+
+// Parse values until the stack is back at `base`. With base 0 that is one
+// complete value; with base > 0 the innermost `base` containers have their
+// brackets outside the input, so their members run up to the end of input.
+template <typename Actions>
+bool parseGrammar(Actions& actions, size_t base) {
+    while (true) {
+        // 解析一个值：容器入栈后继续读取它的第一个成员
+        switch (actions.token().type) {
+            case TokenType::LEFT_BRACE:
+            case TokenType::LEFT_BRACKET: {
+                bool isObject = actions.token().type == TokenType::LEFT_BRACE;
+                if (!actions.startContainer(isObject) || !actions.advance()) {
+                    return false;
+                }
+                if (actions.token().type != (isObject ? TokenType::RIGHT_BRACE : TokenType::RIGHT_BRACKET)) {
+                    if (!actions.push(isObject) || !parseMemberStart(actions)) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (!actions.advance() || !actions.endContainer(isObject, 0)) {
+                    return false;
+                }
+                break;
+            }
+            case TokenType::STRING:
+                if (!actions.string()) {
+                    return false;
+                }
+                break;
+            case TokenType::NUMBER:
+                if (!actions.number()) {
+                    return false;
+                }
+                break;
+            case TokenType::TRUE:
+            case TokenType::FALSE:
+                if (!actions.boolean(actions.token().type == TokenType::TRUE)) {
+                    return false;
+                }
+                break;
+            case TokenType::NULL_:
+                if (!actions.null()) {
+                    return false;
+                }
+                break;
+            default:
+                return actions.fail(GrammarError::ExpectedValue);
+        }
+
+        // 一个值已完成：逗号后继续下一个成员，否则关闭容器并向外层回溯
+        while (true) {
+            size_t depth = actions.depth();
+            if (depth == 0) {
+                return true;
+            }
+            if (actions.token().type == TokenType::COMMA) {
+                if (!actions.advance() || !parseMemberStart(actions)) {
+                    return false;
+                }
+                break;
+            }
+            // 外层容器的括号不在输入中：输入结束即完成，输入里的闭括号不属于它
+            if (depth == base) {
+                if (actions.token().type == TokenType::END_OF_FILE) {
+                    return true;
+                }
+                return actions.fail(GrammarError::ExpectedMemberEnd);
+            }
+            bool isObject = actions.topIsObject();
+            if (actions.token().type != (isObject ? TokenType::RIGHT_BRACE : TokenType::RIGHT_BRACKET)) {
+                return actions.fail(isObject ? GrammarError::ExpectedObjectEnd : GrammarError::ExpectedArrayEnd);
+            }
+            size_t count = actions.pop();
+            if (!actions.advance() || !actions.endContainer(isObject, count)) {
+                return false;
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+} // namespace json
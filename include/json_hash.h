@@ -0,0 +1,132 @@
+#pragma once
+
+#include "json_parser.h"
+#include "json_persistent.h"
+#include "json_sax.h"
+#include "json_value.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Content hash
+//
+// A 64-bit hash of what a value means rather than how it is stored: it
+// agrees with operator== (numbers hash by value, so 1 and 1.0 hash alike;
+// object members hash the same in any order) and depends only on the
+// content, never on the process, platform or std::hash, so it can be stored
+// and compared across runs.
+uint64_t hashValue(const JsonValue& value);
+
+// Same hash; PersistentValue caches it per node (see PersistentValue::hash())
+inline uint64_t hashValue(const PersistentValue& value) { return value.hash(); }
+
+// Same hash without building a tree: the document is hashed from the token
+// stream as it is parsed. Equal to hashValue(JsonParser(input).parse())
+// unless an object repeats a key (in the parser the last value wins; this
+// hashes every occurrence). Throws ParserError like the parser.
+uint64_t hashJson(std::string_view input, const ParseOptions& options = ParseOptions());
+
+// SAX handler that computes the content hash of the events it receives;
+// works with SaxReader and StreamingParser. result() is valid once a
+// complete value has been reported.
+class ContentHasher final : public SaxHandler {
+public:
+    bool onNull() override;
+    bool onBoolean(bool b) override;
+    bool onNumber(double n) override;
+    bool onInteger(int64_t n) override;
+    bool onUnsigned(uint64_t n) override;
+    bool onString(std::string_view s) override;
+    bool onKey(std::string_view key) override;
+    bool onStartObject() override;
+    bool onEndObject(size_t memberCount) override;
+    bool onStartArray() override;
+    bool onEndArray(size_t elementCount) override;
+
+    uint64_t result() const { return result_; }
+
+    // Forget any partial value and start over
+    void reset();
+
+private:
+    struct Frame {
+        bool isObject;
+        uint64_t state;  // Arrays: running hash; objects: sum of member hashes
+        uint64_t key;
+    };
+
+    std::vector<Frame> stack_;
+    uint64_t result_ = 0;
+
+    bool emit(uint64_t hash);
+};
+
+namespace detail {
+
+// Building blocks shared by every way of computing the content hash
+
+// splitmix64 finalizer
+inline uint64_t mixHash(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t combineHash(uint64_t seed, uint64_t value) {
+    return mixHash(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+enum HashTag : uint64_t {
+    kNullTag = 1, kBooleanTag, kNumberTag, kUnsignedTag, kDoubleTag, kStringTag, kArrayTag, kObjectTag
+};
+
+uint64_t hashBytes(std::string_view bytes);
+uint64_t hashInteger(int64_t n);
+uint64_t hashUnsigned(uint64_t n);
+uint64_t hashDouble(double n);
+
+inline uint64_t hashNull() { return mixHash(kNullTag); }
+inline uint64_t hashBoolean(bool b) { return combineHash(kBooleanTag, b ? 1 : 0); }
+inline uint64_t hashString(std::string_view s) { return combineHash(kStringTag, hashBytes(s)); }
+
+// Arrays fold their elements in order; objects add up their members so
+// that member order does not matter
+inline uint64_t arrayHashStart() { return mixHash(kArrayTag); }
+inline uint64_t arrayHashAdd(uint64_t state, uint64_t element) { return combineHash(state, element); }
+inline uint64_t arrayHashFinish(uint64_t state, size_t count) { return combineHash(state, count); }
+
+inline uint64_t objectHashAdd(uint64_t sum, uint64_t key, uint64_t value) {
+    return sum + mixHash(combineHash(key, value));
+}
+inline uint64_t objectHashFinish(uint64_t sum, size_t count) {
+    return combineHash(combineHash(kObjectTag, sum), count);
+}
+
+} // namespace detail
+
+} // namespace json
+
+namespace std {
+
+template <>
+struct hash<json::JsonValue> {
+    size_t operator()(const json::JsonValue& value) const {
+        return static_cast<size_t>(json::hashValue(value));
+    }
+};
+
+template <>
+struct hash<json::PersistentValue> {
+    size_t operator()(const json::PersistentValue& value) const {
+        return static_cast<size_t>(value.hash());
+    }
+};
+
+} // namespace std
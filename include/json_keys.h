@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Handle to a key stored in a KeyTable
+//
+// Each distinct key is stored once, so two handles from the same table are
+// equal exactly when their keys are, and comparing them compares pointers.
+// A default-constructed handle is null.
+class InternedKey {
+public:
+    InternedKey() = default;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+    explicit operator bool() const { return data_ != nullptr; }
+    bool operator==(InternedKey other) const { return data_ == other.data_; }
+    bool operator!=(InternedKey other) const { return data_ != other.data_; }
+
+private:
+    friend class KeyTable;
+    InternedKey(const char* data, uint32_t size) : data_(data), size_(size) {}
+
+    const char* data_ = nullptr;
+    uint32_t size_ = 0;
+};
+
+// Usage counters of a KeyTable
+struct KeyTableStats {
+    size_t keys = 0;          // Distinct keys stored
+    size_t keyBytes = 0;      // Bytes of key text
+    size_t memoryBytes = 0;   // Text blocks plus hash slots
+    uint64_t lookups = 0;     // intern() calls
+    uint64_t hits = 0;        // ... that found a stored key
+    uint64_t rejected = 0;    // ... that missed while the table was full or frozen
+
+    double hitRate() const { return lookups ? static_cast<double>(hits) / lookups : 0.0; }
+};
+
+// Key dictionary shared across parses
+//
+// Set ParseOptions::keys to make Document parsing store object keys here
+// instead of in each document's arena; every DocMember::key then points at
+// the table, which must outlive those documents. Keys are never removed.
+//
+// intern() may be called from any number of threads. Lookups take a shared
+// lock and inserts an exclusive one; after freeze() the table is read-only
+// and lookups take no lock at all. Once `maxKeys` keys are stored, or once
+// the table is frozen, new keys are rejected (intern() returns a null handle
+// and the parser copies the key into the document instead), so hostile input
+// with random keys cannot grow the table without bound.
+class KeyTable {
+public:
+    explicit KeyTable(size_t maxKeys = 65536);
+
+    KeyTable(const KeyTable&) = delete;
+    KeyTable& operator=(const KeyTable&) = delete;
+
+    // Stored handle for `key`, inserting it if there is room
+    InternedKey intern(std::string_view key);
+
+    // Stored handle for `key`, or a null handle; does not insert or count
+    InternedKey find(std::string_view key) const;
+
+    // Stop inserting; later lookups are lock-free
+    void freeze();
+    bool frozen() const { return frozen_.load(std::memory_order_acquire); }
+
+    size_t size() const;
+    KeyTableStats stats() const;
+
+private:
+    struct Slot {
+        size_t hash;
+        const char* data;  // Null for an empty slot
+        uint32_t size;
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::atomic<bool> frozen_{false};
+    size_t maxKeys_;
+
+    std::vector<Slot> slots_;  // Open addressing, power-of-two size
+    size_t count_ = 0;
+    size_t keyBytes_ = 0;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t blockBytes_ = 0;
+    char* cursor_ = nullptr;
+    size_t remaining_ = 0;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> rejected_{0};
+
+    InternedKey lookup(std::string_view key, size_t hash) const;
+    InternedKey insert(std::string_view key, size_t hash);
+    void rehash(size_t capacity);
+};
+
+} // namespace json
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <stdexcept>
+#include "json_structural.h"
 
 namespace json {
 
@@ -28,14 +30,42 @@ enum class TokenType {
     ERROR          // Error
 };
 
+// Kind of lexical error an ERROR token reports
+enum class LexErrorKind : unsigned char {
+    None,
+    UnexpectedCharacter,  // Byte that cannot start a token
+    InvalidLiteral,       // Misspelled true, false or null
+    InvalidNumber,        // Missing digits in a number
+    InvalidEscape,        // Bad backslash or \u escape in a string
+    ControlCharacter,     // Unescaped control character in a string
+    UnterminatedString
+};
+
 // Token structure
+//
+// `value` is a span into the lexer input: the raw contents of a string
+// (without quotes), the text of a number, or a static error message.
+// Structural tokens and literals carry an empty span.
 struct Token {
-    TokenType type;
-    std::string value;
+    TokenType type = TokenType::END_OF_FILE;
+    std::string_view value;
+    bool escaped = false;  // STRING only: raw value contains backslash escapes
+    size_t offset = 0;     // Byte offset of the token in the input
+    LexErrorKind error = LexErrorKind::None;  // ERROR only
+};
+
+// Line/column of a byte offset (both 1-based)
+struct SourceLocation {
     size_t line;
     size_t column;
 };
 
+// How the lexer finds the next token
+enum class ScanMode {
+    Sequential,  // Skip whitespace byte by byte
+    Indexed      // Build a StructuralIndex first and jump between its entries
+};
+
 // Lexer exception
 class LexerError : public std::runtime_error {
 public:
@@ -44,35 +74,61 @@ public:
 };
 
 // Lexer
+//
+// The lexer borrows its input: the buffer must outlive the lexer and every
+// token it returns.
 class JsonLexer {
 public:
-    explicit JsonLexer(const std::string& input);
+    explicit JsonLexer(std::string_view input = std::string_view(),
+                       ScanMode mode = ScanMode::Sequential,
+                       SimdLevel level = SimdLevel::Auto);
+
+    // Start over on a new input with the same mode, keeping the structural
+    // index allocation
+    void reset(std::string_view input);
     
     // Get next token
     Token nextToken();
     
-    // Get current position
-    size_t getLine() const { return line_; }
-    size_t getColumn() const { return column_; }
+    // Get current position; computed on demand from the byte offset
+    size_t getLine() const { return locate(current_).line; }
+    size_t getColumn() const { return locate(current_).column; }
+
+    // Byte offset just past the last token returned
+    size_t position() const { return current_; }
+
+    // Line/column of an arbitrary offset, e.g. Token::offset
+    SourceLocation locate(size_t offset) const;
+
+    // Decode the raw contents of an escaped STRING token, appending to `out`.
+    // The escapes have already been validated by the lexer.
+    static void unescape(std::string_view raw, std::string& out);
 
 private:
-    std::string input_;
+    std::string_view input_;
     size_t current_;
-    size_t line_;
-    size_t column_;
+    size_t start_;  // Offset of the token being scanned
+    ScanMode mode_;
+    SimdLevel level_;
+    bool indexed_;
+    StructuralIndex index_;
+    size_t nextStructural_;
     
     // Helper functions
-    char advance();
+    char advance() { return input_[current_++]; }
     char peek() const;
     bool isAtEnd() const;
     void skipWhitespace();
-    Token makeToken(TokenType type, const std::string& value = "");
-    Token makeError(const std::string& message);
+    void seekIndexed();
+    Token makeToken(TokenType type, std::string_view value = {});
+    Token makeError(LexErrorKind kind, const char* message);
     
     // Token handlers
+    Token scanToken();
     Token scanString();
+    Token scanIndexedString();
     Token scanNumber();
     Token scanIdentifier();
 };
 
-} // namespace json 
\ No newline at end of file
+} // namespace json 
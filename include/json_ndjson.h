@@ -0,0 +1,76 @@
+#pragma once
+
+#include "json_parser.h"
+#include "json_thread_pool.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Options for NdjsonReader
+struct NdjsonOptions {
+    size_t threads = 0;            // Parsing threads including the caller; 0 = hardware threads
+    size_t batchBytes = 256 << 10; // Input bytes handed to one task
+    ParseOptions parse;            // Applied to every record
+};
+
+// One record of a newline-delimited JSON input
+struct NdjsonRecord {
+    size_t line = 0;    // 1-based line of the record in the input
+    JsonValue value;    // Parsed value, null if the record failed
+    std::string error;  // ParserError message, empty on success
+
+    bool ok() const { return error.empty(); }
+};
+
+// Newline-delimited JSON (NDJSON / JSON Lines) reader
+//
+// JSON text cannot contain a raw newline outside whitespace, so the input
+// is cut at '\n' into batches of roughly `batchBytes` without looking at the
+// records themselves. The batches are parsed on a work-stealing ThreadPool.
+// Lines that are empty or only whitespace are skipped; a trailing '\r' is
+// ignored. A record that fails to parse does not stop the others.
+class NdjsonReader {
+public:
+    explicit NdjsonReader(const NdjsonOptions& options = NdjsonOptions());
+    // Run on an existing pool; options.threads is ignored
+    explicit NdjsonReader(ThreadPool& pool, const NdjsonOptions& options = NdjsonOptions());
+
+    NdjsonReader(const NdjsonReader&) = delete;
+    NdjsonReader& operator=(const NdjsonReader&) = delete;
+
+    // Parse every record and return them in input order
+    std::vector<NdjsonRecord> parse(std::string_view input);
+
+    // Hand each record to `callback` as soon as it is parsed. The callback is
+    // called concurrently from several threads and in no particular order.
+    using Callback = std::function<void(NdjsonRecord&&)>;
+    void parseUnordered(std::string_view input, const Callback& callback);
+
+    // Statistics of the last parse() or parseUnordered(), summed over its
+    // records; all zero unless built with JSONPARSER_ENABLE_STATS
+    const ParseStats& stats() const { return stats_; }
+
+private:
+    struct Batch {
+        size_t begin;
+        size_t end;
+        size_t firstLine;
+    };
+
+    std::vector<Batch> split(std::string_view input);
+    void run(size_t count, const std::function<void(size_t)>& body);
+    void parseBatch(std::string_view input, const Batch& batch, const Callback& emit,
+                    ParseStats& stats) const;
+    void collectStats(const std::vector<ParseStats>& batchStats);
+
+    NdjsonOptions options_;
+    std::unique_ptr<ThreadPool> ownedPool_;
+    ThreadPool* pool_ = nullptr;
+    ParseStats stats_;
+};
+
+} // namespace json
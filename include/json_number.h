@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace json {
+
+// A decoded JSON number
+//
+// Integers without a fraction or exponent that fit in 64 bits keep their
+// exact value; everything else is converted to the nearest double.
+struct NumberValue {
+    enum class Kind : uint8_t { Int64, UInt64, Double };
+
+    Kind kind = Kind::Int64;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+    };
+
+    NumberValue() : i(0) {}
+};
+
+// The same number in canonical form: a double with an integral value that
+// fits in 64 bits becomes Int64 (or UInt64 above INT64_MAX), an UInt64 that
+// fits becomes Int64, and -0.0 becomes 0. Numbers are equal exactly when
+// their canonical forms are.
+NumberValue canonicalNumber(NumberValue number);
+
+// Exact equality by value: 1 == 1.0, but 9007199254740993 != 9007199254740992.0
+bool sameNumber(const NumberValue& a, const NumberValue& b);
+
+// Decode the text of a NUMBER token (already validated by the lexer).
+// Short numbers take an exact fast path; others go through std::from_chars.
+// Neither depends on the locale. Throws ParserError if the value does not
+// fit in a double.
+NumberValue parseNumber(std::string_view text);
+
+// Same, but returns false instead of throwing when the value does not fit
+bool tryParseNumber(std::string_view text, NumberValue& number);
+
+// Longest output of formatNumber
+constexpr size_t kMaxNumberLength = 32;
+
+// Write the shortest text that parses back to exactly `value` (no trailing
+// zeros, exponent form where shorter) and return its length. Non-finite
+// values have no JSON representation and are written as null.
+size_t formatNumber(double value, char* buffer);
+size_t formatNumber(int64_t value, char* buffer);
+size_t formatNumber(uint64_t value, char* buffer);
+
+} // namespace json
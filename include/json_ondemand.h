@@ -0,0 +1,178 @@
+#pragma once
+
+#include "json_value.h"
+#include "json_number.h"
+#include "json_structural.h"
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace json {
+
+class LazyDocument;
+class LazyObject;
+class LazyArray;
+
+// On-demand value
+//
+// A position in a LazyDocument's structural index. Nothing is decoded until
+// an accessor is called, and only the path that is walked gets inspected:
+// siblings are skipped by bracket matching over the index. Accessors follow
+// JsonValue: a type mismatch throws std::bad_variant_access, a missing key
+// or index throws std::out_of_range, and malformed input that is actually
+// touched throws ParserError.
+class LazyValue {
+public:
+    // Type checks (look at the first byte only)
+    bool isObject() const { return first() == '{'; }
+    bool isArray() const { return first() == '['; }
+    bool isString() const { return first() == '"'; }
+    bool isNumber() const;
+    bool isInt() const;
+    bool isBoolean() const { return first() == 't' || first() == 'f'; }
+    bool isNull() const { return first() == 'n'; }
+
+    // Get value
+    LazyObject asObject() const;
+    LazyArray asArray() const;
+    std::string asString() const;
+    double asNumber() const;
+    int64_t asInt64() const;
+    uint64_t asUint64() const;
+    bool asBoolean() const;
+
+    // Shorthand for asObject().at(key) / asArray().at(index)
+    LazyValue operator[](std::string_view key) const;
+    LazyValue operator[](size_t index) const;
+
+    // Raw JSON text of this value and a fully parsed copy of it
+    std::string_view raw() const;
+    JsonValue materialize() const;
+
+private:
+    friend class LazyDocument;
+    friend class LazyObject;
+    friend class LazyArray;
+
+    LazyValue(const LazyDocument* doc, size_t entry) : doc_(doc), entry_(entry) {}
+
+    const LazyDocument* doc_;
+    size_t entry_;  // Index of the value's first entry in the structural index
+
+    char first() const;
+    NumberValue number() const;
+};
+
+// Object view; members are found by walking the object's entries
+class LazyObject {
+public:
+    class iterator {
+    public:
+        std::pair<std::string, LazyValue> operator*() const;
+        iterator& operator++();
+        bool operator==(const iterator& other) const { return entry_ == other.entry_; }
+        bool operator!=(const iterator& other) const { return entry_ != other.entry_; }
+
+    private:
+        friend class LazyObject;
+        iterator(const LazyDocument* doc, size_t entry) : doc_(doc), entry_(entry) {}
+
+        const LazyDocument* doc_;
+        size_t entry_;  // Entry of the member's key, or npos at the end
+    };
+
+    iterator begin() const;
+    iterator end() const;
+
+    size_t size() const;
+    bool empty() const { return begin() == end(); }
+
+    // Lookup stops at the first member with this key
+    LazyValue at(std::string_view key) const;
+    LazyValue operator[](std::string_view key) const { return at(key); }
+    size_t count(std::string_view key) const;
+
+private:
+    friend class LazyValue;
+    LazyObject(const LazyDocument* doc, size_t entry) : doc_(doc), entry_(entry) {}
+
+    const LazyDocument* doc_;
+    size_t entry_;  // Entry of '{'
+
+    // Entry of the first member key, npos for an empty object
+    size_t firstMember() const;
+    bool findMember(std::string_view key, size_t& valueEntry) const;
+};
+
+// Array view; elements are reached by skipping their predecessors
+class LazyArray {
+public:
+    class iterator {
+    public:
+        LazyValue operator*() const { return LazyValue(doc_, entry_); }
+        iterator& operator++();
+        bool operator==(const iterator& other) const { return entry_ == other.entry_; }
+        bool operator!=(const iterator& other) const { return entry_ != other.entry_; }
+
+    private:
+        friend class LazyArray;
+        iterator(const LazyDocument* doc, size_t entry) : doc_(doc), entry_(entry) {}
+
+        const LazyDocument* doc_;
+        size_t entry_;  // Entry of the element, or npos at the end
+    };
+
+    iterator begin() const;
+    iterator end() const;
+
+    size_t size() const;
+    bool empty() const { return begin() == end(); }
+
+    LazyValue at(size_t index) const;
+    LazyValue operator[](size_t index) const { return at(index); }
+
+private:
+    friend class LazyValue;
+    LazyArray(const LazyDocument* doc, size_t entry) : doc_(doc), entry_(entry) {}
+
+    const LazyDocument* doc_;
+    size_t entry_;  // Entry of '['
+};
+
+// On-demand document
+//
+// Construction only builds the structural index; values are decoded when
+// accessed. The input must outlive the document, and the document must
+// outlive every LazyValue taken from it. Only the parts of the input that are
+// accessed are validated.
+class LazyDocument {
+public:
+    explicit LazyDocument(std::string_view input, SimdLevel level = SimdLevel::Auto);
+
+    LazyDocument(const LazyDocument&) = delete;
+    LazyDocument& operator=(const LazyDocument&) = delete;
+
+    LazyValue root() const { return LazyValue(this, 0); }
+    LazyValue operator[](std::string_view key) const { return root()[key]; }
+    LazyValue operator[](size_t index) const { return root()[index]; }
+
+private:
+    friend class LazyValue;
+    friend class LazyObject;
+    friend class LazyArray;
+
+    std::string_view input_;
+    StructuralIndex index_;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    char charAt(size_t entry) const;
+    size_t offsetOf(size_t entry) const;
+    size_t skip(size_t entry) const;
+    size_t nextMember(size_t valueEntry, char close) const;
+    bool keyEquals(size_t entry, std::string_view key) const;
+    std::string decodeKey(size_t entry) const;
+    [[noreturn]] void fail(const std::string& message, size_t entry) const;
+};
+
+} // namespace json
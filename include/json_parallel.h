@@ -0,0 +1,63 @@
+#pragma once
+
+#include "json_parser.h"
+#include "json_thread_pool.h"
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Options for ParallelParser
+struct ParallelOptions {
+    size_t threads = 0;             // Parsing threads including the caller; 0 = hardware threads
+    size_t chunkBytes = 1 << 20;    // Input bytes handed to one task
+    ParseOptions parse;
+};
+
+// Parser for a single large array or object
+//
+// A scan over the input finds the commas that separate the top-level
+// elements or members: one parallel pass counts quotes per chunk, which
+// tells whether each chunk starts inside a string, and a second one tracks
+// bracket depth. The document is cut at the first top-level comma after each
+// chunk boundary, the pieces are parsed on a work-stealing ThreadPool, and
+// their elements (or members) are moved into the final Array (or Object).
+//
+// The result is identical to JsonParser::parse(), including the order of
+// object members and the handling of duplicate keys. Input that is not a
+// top-level array or object, is smaller than two chunks, or fails to parse
+// in any piece is handed to the serial parser, so errors carry the same
+// message and position as well.
+class ParallelParser {
+public:
+    explicit ParallelParser(const ParallelOptions& options = ParallelOptions());
+    // Run on an existing pool; options.threads is ignored
+    explicit ParallelParser(ThreadPool& pool, const ParallelOptions& options = ParallelOptions());
+
+    ParallelParser(const ParallelParser&) = delete;
+    ParallelParser& operator=(const ParallelParser&) = delete;
+
+    // Parse `input`; throws ParserError
+    JsonValue parse(std::string_view input);
+
+    // Pieces the last parse() was parsed in; 1 if it ran serially
+    size_t pieces() const { return pieces_; }
+
+private:
+    struct Piece {
+        size_t begin;
+        size_t end;
+    };
+
+    std::vector<Piece> split(std::string_view input, size_t open, size_t close);
+    void run(size_t count, const std::function<void(size_t)>& body);
+
+    ParallelOptions options_;
+    std::unique_ptr<ThreadPool> ownedPool_;
+    ThreadPool* pool_ = nullptr;
+    size_t pieces_ = 0;
+};
+
+} // namespace json
@@ -2,7 +2,11 @@
 
 #include "json_value.h"
 #include "json_lexer.h"
+#include "json_stats.h"
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace json {
 
@@ -13,33 +17,94 @@ public:
         : std::runtime_error(message) {}
 };
 
+// Default nesting limit for arrays and objects
+constexpr size_t kDefaultMaxDepth = 1024;
+
+class KeyTable;
+
+// Parse-time options
+struct ParseOptions {
+    // Reject input that is not well-formed UTF-8. The lexer only inspects
+    // ASCII bytes, so without this, malformed sequences inside strings are
+    // passed through unchanged.
+    bool validateUtf8 = false;
+
+    // Deepest nesting of arrays and objects accepted; deeper input fails
+    // with "Maximum nesting depth exceeded"
+    size_t maxDepth = kDefaultMaxDepth;
+
+    // Store object keys of Document parses in this shared table instead of
+    // each document's arena (see KeyTable). JsonValue keys are always owned
+    // strings, so JsonParser::parse() into a JsonValue ignores it.
+    KeyTable* keys = nullptr;
+};
+
+// Run the input checks selected by `options`; throws ParserError
+void checkInput(std::string_view input, const ParseOptions& options);
+
+class Document;
+class DocumentBuilder;
+
+// Working memory of a SaxReader. Passing the same buffers to successive
+// readers keeps their capacity, so a warmed-up parser does not allocate.
+struct SaxBuffers {
+    struct Frame {
+        bool isObject;
+        size_t count;  // Members or elements started so far
+    };
+
+    std::string scratch;       // Decoded escaped strings
+    std::vector<Frame> stack;  // Open containers
+};
+
+
 // JSON parser
+//
+// The parser borrows its input without copying it; the buffer must stay
+// alive until parse() returns. The grammar itself lives in SaxReader
+// (json_sax.h); JsonParser feeds its events to a ValueBuilder or a
+// DocumentBuilder.
+//
+// A parser can be reused: the structural index, the string scratch buffer
+// and the document builder's stacks keep their capacity between calls, and
+// parse(input, doc) rebuilds `doc` inside its existing arena. Once warmed
+// up on messages of a similar shape, parsing into a Document does no heap
+// allocation.
 class JsonParser {
 public:
-    explicit JsonParser(const std::string& input);
-    
-    // Parse JSON string
+    // Reusable parser; pass the input to parse()
+    explicit JsonParser(const ParseOptions& options = ParseOptions());
+    explicit JsonParser(std::string_view input, const ParseOptions& options = ParseOptions());
+    ~JsonParser();
+
+    JsonParser(const JsonParser&) = delete;
+    JsonParser& operator=(const JsonParser&) = delete;
+
+    // Parse the input given to the constructor
     JsonValue parse();
 
+    // Parse `input` into a new value
+    JsonValue parse(std::string_view input);
+
+    // Parse `input` into `doc`, replacing its contents and reusing its arena.
+    // Strings are copied, so `input` may be released afterwards. If parsing
+    // throws, `doc` is left holding null.
+    void parse(std::string_view input, Document& doc);
+
+    // Statistics of the last parse; all zero unless the library is built
+    // with JSONPARSER_ENABLE_STATS (see ParseStats)
+    const ParseStats& stats() const { return stats_; }
+
 private:
-    std::unique_ptr<JsonLexer> lexer_;
-    Token current_;
-    Token previous_;
-    
-    // Helper functions
-    void advance();
-    bool check(TokenType type) const;
-    bool match(TokenType type);
-    Token consume(TokenType type, const std::string& message);
-    
-    // Value parsers
-    JsonValue parseValue();
-    JsonValue parseObject();
-    JsonValue parseArray();
-    JsonValue parseString();
-    JsonValue parseNumber();
-    JsonValue parseBoolean();
-    JsonValue parseNull();
+    std::string_view input_;
+    ParseOptions options_;
+    JsonLexer lexer_;
+    SaxBuffers buffers_;
+    std::unique_ptr<DocumentBuilder> documentBuilder_;
+    ParseStats stats_;
+
+    ParseStats* statsTarget() { return kStatsEnabled ? &stats_ : nullptr; }
+    void start(std::string_view input);
 };
 
-} // namespace json 
\ No newline at end of file
+} // namespace json
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "json_persistent.h"
+#include "json_value.h"
+#include <stdexcept>
+#include <string>
+
+namespace json {
+
+// Malformed patch, or an operation that cannot be applied
+class PatchError : public std::runtime_error {
+public:
+    explicit PatchError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+// JSON Patch (RFC 6902)
+//
+// `patch` is an array of operations ("add", "remove", "replace", "move",
+// "copy", "test") addressed by JSON Pointer. Each operation copies only the
+// containers on its path and shares everything else with `document`, which
+// is never modified: if any operation fails, PatchError is thrown and no
+// partial result is visible.
+PersistentValue applyPatch(const PersistentValue& document, const JsonValue& patch);
+
+// JSON Merge Patch (RFC 7396): members of an object patch are merged
+// recursively, null members delete, anything else replaces the target
+PersistentValue applyMergePatch(const PersistentValue& document, const JsonValue& patch);
+
+// JSON Patch that turns `from` into `to`
+//
+// Subtrees the two versions share are skipped without being visited, so
+// diffing a version against one derived from it by a patch costs time in
+// proportion to the changed paths, not to the document. Objects are
+// compared by key; arrays element by element, with removals or additions at
+// the end.
+JsonValue diff(const PersistentValue& from, const PersistentValue& to);
+
+} // namespace json
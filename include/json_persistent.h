@@ -0,0 +1,120 @@
+#pragma once
+
+#include "json_value.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace json {
+
+// Immutable JSON value with shared structure
+//
+// Strings, arrays and objects live in reference-counted nodes that are never
+// modified once built, so copying a PersistentValue is O(1) and an update
+// (setMember(), insertElement(), ...) returns a new version that copies only
+// the containers on the path to the change; every other subtree is shared
+// with the old version. Old versions stay valid and unchanged, and because
+// nodes are immutable any number of threads may read them without locking
+// (as with shared_ptr, a single PersistentValue variable must not be
+// assigned while another thread reads it).
+//
+// Objects keep insertion order like JsonObject. Conversion to and from
+// JsonValue and comparison recurse once per nesting level.
+class PersistentValue {
+public:
+    using Member = std::pair<std::string, PersistentValue>;
+    using Array = std::vector<PersistentValue>;
+    using Members = std::vector<Member>;
+
+    PersistentValue() : value_(nullptr) {}
+    PersistentValue(std::nullptr_t) : value_(nullptr) {}
+    PersistentValue(bool b) : value_(b) {}
+    PersistentValue(double num) : value_(num) {}
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    PersistentValue(T num)
+        : value_(std::in_place_type<std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>, num) {}
+    PersistentValue(const char* str) : PersistentValue(std::string(str)) {}
+    PersistentValue(std::string str);
+
+    // Deep conversion from a tree
+    explicit PersistentValue(const JsonValue& value);
+
+    static PersistentValue array(Array elements = {});
+    // Keys must be distinct
+    static PersistentValue object(Members members = {});
+
+    JsonValue toJson() const;
+
+    // Type checks
+    bool isNull() const { return std::holds_alternative<std::nullptr_t>(value_); }
+    bool isBoolean() const { return std::holds_alternative<bool>(value_); }
+    bool isInt() const {
+        return std::holds_alternative<int64_t>(value_) || std::holds_alternative<uint64_t>(value_);
+    }
+    bool isDouble() const { return std::holds_alternative<double>(value_); }
+    bool isNumber() const { return isInt() || isDouble(); }
+    bool isString() const { return std::holds_alternative<StringNode>(value_); }
+    bool isArray() const { return std::holds_alternative<ArrayNode>(value_); }
+    bool isObject() const { return std::holds_alternative<ObjectNode>(value_); }
+
+    // Get value; the wrong type throws std::bad_variant_access
+    bool asBoolean() const { return std::get<bool>(value_); }
+    double asNumber() const;
+    const std::string& asString() const { return *std::get<StringNode>(value_); }
+    const Array& elements() const;
+    const Members& members() const;
+
+    // Elements or members; 0 for scalars
+    size_t size() const;
+
+    // Element `index`; throws std::out_of_range
+    const PersistentValue& at(size_t index) const;
+    // Member value, or nullptr if the key is missing or this is not an object
+    const PersistentValue* find(std::string_view key) const;
+
+    // Updated versions; *this is left unchanged. Objects: setMember() adds
+    // or replaces a member, eraseMember() removes one if present. Arrays:
+    // `index` must be < size() (<= size() for insertElement()), otherwise
+    // std::out_of_range is thrown. Calling these on the wrong type throws
+    // std::bad_variant_access.
+    PersistentValue setMember(std::string key, PersistentValue value) const;
+    PersistentValue eraseMember(std::string_view key) const;
+    PersistentValue setElement(size_t index, PersistentValue value) const;
+    PersistentValue insertElement(size_t index, PersistentValue value) const;
+    PersistentValue eraseElement(size_t index) const;
+
+    // True if both values hold the same node (strings and containers) or the
+    // same scalar, so they are equal without looking inside
+    bool shares(const PersistentValue& other) const;
+
+    // Deep comparison; numbers compare by exact value (1 == 1.0) and object
+    // members in any order. Shared nodes compare equal immediately, and
+    // containers whose cached hashes differ compare unequal immediately.
+    bool operator==(const PersistentValue& other) const;
+    bool operator!=(const PersistentValue& other) const { return !(*this == other); }
+
+    // Content hash, equal to hashValue(toJson()) (see json_hash.h). Arrays
+    // and objects cache theirs on first use, so hashing a new version only
+    // visits the containers an update copied.
+    uint64_t hash() const;
+
+private:
+    struct ArrayData;
+    struct ObjectData;
+    using StringNode = std::shared_ptr<const std::string>;
+    using ArrayNode = std::shared_ptr<const ArrayData>;
+    using ObjectNode = std::shared_ptr<const ObjectData>;
+
+    std::variant<std::nullptr_t, bool, int64_t, uint64_t, double, StringNode, ArrayNode, ObjectNode> value_;
+
+    const ObjectData& objectData() const;
+    // Cached hash of an array or object, 0 if not computed yet or a scalar
+    uint64_t cachedHash() const;
+};
+
+} // namespace json
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "json_value.h"
+#include "json_parser.h"
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Malformed JSON Pointer or JSONPath expression
+class QueryError : public std::runtime_error {
+public:
+    explicit QueryError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+// Compiled path into a document
+//
+// Built once from either syntax and reused for every document:
+//   - JSON Pointer (RFC 6901): "/person/address/city", "/items/0", "" for
+//     the root; "~0" and "~1" stand for '~' and '/'. A token selects an
+//     object member or, when it is a canonical decimal, an array element.
+//   - A JSONPath subset: "$", ".name", "['name']", "[0]", ".*" and "[*]".
+// A path without wildcards selects at most one value.
+class JsonPath {
+public:
+    static JsonPath fromPointer(std::string_view pointer);
+    static JsonPath fromJsonPath(std::string_view path);
+
+    // First selected value, or nullptr if the path matches nothing
+    const JsonValue* find(const JsonValue& root) const;
+
+    // All selected values in document order
+    std::vector<const JsonValue*> findAll(const JsonValue& root) const;
+
+    // True if the path has no wildcards
+    bool isSingular() const { return prefix_ == steps_.size(); }
+
+    // The expression the path was compiled from
+    const std::string& text() const { return text_; }
+
+private:
+    friend class QueryMatcher;
+
+    struct Step {
+        enum class Kind : uint8_t {
+            Token,     // Pointer token: member name, or element if numeric
+            Name,      // JSONPath member name
+            Index,     // JSONPath element index
+            Wildcard   // Every member or element
+        };
+
+        Kind kind;
+        std::string name;
+        size_t index;  // npos unless the step can select an array element
+
+        bool matchesKey(std::string_view key) const {
+            return kind == Kind::Wildcard || ((kind == Kind::Token || kind == Kind::Name) && key == name);
+        }
+        bool matchesIndex(size_t i) const {
+            return kind == Kind::Wildcard || ((kind == Kind::Token || kind == Kind::Index) && i == index);
+        }
+    };
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    std::string text_;
+    std::vector<Step> steps_;
+    size_t prefix_ = 0;  // Steps before the first wildcard
+
+    JsonPath() = default;
+    void finish();
+    void collect(const JsonValue& value, size_t step, std::vector<const JsonValue*>& out,
+                 bool firstOnly) const;
+};
+
+// JSON Pointer helpers
+
+// Reference tokens of `pointer`, with "~1" and "~0" decoded; throws QueryError
+std::vector<std::string> splitPointer(std::string_view pointer);
+
+// Append '/' and `token` to `pointer`, encoding '~' and '/'
+void appendPointerToken(std::string& pointer, std::string_view token);
+
+// Array index named by a reference token, or SIZE_MAX unless the token is a
+// decimal without leading zeros
+size_t pointerIndex(std::string_view token);
+
+// Set of paths evaluated together
+//
+// evaluate() looks every path up in a JsonValue. scan() runs on the token
+// stream without building the document: only the selected values are
+// materialized, and lexing stops as soon as every path is resolved - after
+// the first match of a singular path, or once the value its wildcards range
+// over has ended. Input past that point is never read, so it is not checked
+// for errors either. With duplicate keys scan() sees the first occurrence.
+class JsonQuery {
+public:
+    // Values selected by each path, indexed like the paths
+    using Result = std::vector<std::vector<JsonValue>>;
+
+    JsonQuery() = default;
+    JsonQuery(std::initializer_list<JsonPath> paths) : paths_(paths) {}
+
+    // Add a path; returns its index in the result
+    size_t add(JsonPath path);
+
+    size_t size() const { return paths_.size(); }
+    const JsonPath& path(size_t index) const { return paths_[index]; }
+
+    // Look every path up in a parsed value
+    Result evaluate(const JsonValue& root) const;
+
+    // Match the paths against raw JSON text without parsing it into a value
+    Result scan(std::string_view input, const ParseOptions& options = ParseOptions()) const;
+
+private:
+    std::vector<JsonPath> paths_;
+};
+
+} // namespace json
@@ -0,0 +1,434 @@
+#pragma once
+
+#include "json_grammar.h"
+#include "json_lexer.h"
+#include "json_number.h"
+#include "json_parser.h"
+#include "json_stats.h"
+#include "json_value.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace json {
+
+// Event handler interface
+//
+// Every callback returns true to continue or false to stop parsing early.
+// Strings and keys are only valid for the duration of the callback: they
+// point into the input when the string has no escapes and into a scratch
+// buffer otherwise. Integers that fit in 64 bits are reported through
+// onInteger/onUnsigned, which forward to onNumber unless overridden.
+class SaxHandler {
+public:
+    virtual ~SaxHandler() = default;
+
+    virtual bool onNull() { return true; }
+    virtual bool onBoolean(bool) { return true; }
+    virtual bool onNumber(double) { return true; }
+    virtual bool onInteger(int64_t value) { return onNumber(static_cast<double>(value)); }
+    virtual bool onUnsigned(uint64_t value) { return onNumber(static_cast<double>(value)); }
+    virtual bool onString(std::string_view) { return true; }
+    virtual bool onKey(std::string_view) { return true; }
+    virtual bool onStartObject() { return true; }
+    virtual bool onEndObject(size_t /*memberCount*/) { return true; }
+    virtual bool onStartArray() { return true; }
+    virtual bool onEndArray(size_t /*elementCount*/) { return true; }
+};
+
+// Builds a JsonValue from events
+//
+// With statistics compiled in and `stats` given, the heap blocks requested
+// for the value are added to stats->allocations and allocatedBytes.
+class ValueBuilder final : public SaxHandler {
+public:
+    explicit ValueBuilder(ParseStats* stats = nullptr) : stats_(stats) {}
+
+    bool onNull() override { return emit(JsonValue(nullptr)); }
+    bool onBoolean(bool b) override { return emit(JsonValue(b)); }
+    bool onNumber(double n) override { return emit(JsonValue(n)); }
+    bool onInteger(int64_t n) override { return emit(JsonValue(n)); }
+    bool onUnsigned(uint64_t n) override { return emit(JsonValue(n)); }
+    bool onString(std::string_view s) override {
+        countString(s.size());
+        return emit(JsonValue(std::string(s)));
+    }
+
+    bool onKey(std::string_view key) override {
+        countString(key.size());
+        stack_.back().key.assign(key.data(), key.size());
+        return true;
+    }
+
+    bool onStartObject() override {
+        stack_.push_back(Frame{true, {}, {}, {}});
+        return true;
+    }
+
+    bool onEndObject(size_t) override {
+        JsonValue::Object object = std::move(stack_.back().object);
+        stack_.pop_back();
+        return emit(JsonValue(std::move(object)));
+    }
+
+    bool onStartArray() override {
+        stack_.push_back(Frame{false, {}, {}, {}});
+        return true;
+    }
+
+    bool onEndArray(size_t) override {
+        JsonValue::Array array = std::move(stack_.back().array);
+        stack_.pop_back();
+        return emit(JsonValue(std::move(array)));
+    }
+
+    // The completed value
+    JsonValue take() { return std::move(root_); }
+
+    // Contents of the outermost container when the input did not close it,
+    // e.g. after SaxReader::parseMembers() following onStartArray() or
+    // onStartObject(); clears the builder
+    JsonValue::Array takeArray() {
+        assert(!stack_.empty());
+        JsonValue::Array array = std::move(stack_.front().array);
+        stack_.clear();
+        return array;
+    }
+
+    JsonValue::Object takeObject() {
+        assert(!stack_.empty());
+        JsonValue::Object object = std::move(stack_.front().object);
+        stack_.clear();
+        return object;
+    }
+
+    void reset() {
+        stack_.clear();
+        root_ = JsonValue();
+    }
+
+private:
+    struct Frame {
+        bool isObject;
+        JsonValue::Object object;
+        JsonValue::Array array;
+        std::string key;
+    };
+
+    std::vector<Frame> stack_;
+    JsonValue root_;
+    ParseStats* stats_;
+
+    bool emit(JsonValue&& value) {
+        if (stack_.empty()) {
+            root_ = std::move(value);
+        } else if (stack_.back().isObject) {
+            JsonValue::Object& object = stack_.back().object;
+            size_t capacity = object.capacity();
+            object[std::move(stack_.back().key)] = std::move(value);
+            countGrowth(capacity, object.capacity(), sizeof(JsonValue::Object::value_type));
+        } else {
+            JsonValue::Array& array = stack_.back().array;
+            size_t capacity = array.capacity();
+            array.push_back(std::move(value));
+            countGrowth(capacity, array.capacity(), sizeof(JsonValue));
+        }
+        return true;
+    }
+
+    // Keys and strings move into the value, so each one longer than the
+    // small-string buffer is one allocation
+    void countString(size_t size) {
+        if constexpr (kStatsEnabled) {
+            static const size_t smallString = std::string().capacity();
+            if (stats_ && size > smallString) {
+                stats_->allocations++;
+                stats_->allocatedBytes += size + 1;
+            }
+        }
+    }
+
+    void countGrowth(size_t before, size_t after, size_t elementSize) {
+        if constexpr (kStatsEnabled) {
+            if (stats_ && after != before) {
+                stats_->allocations++;
+                stats_->allocatedBytes += after * elementSize;
+            }
+        }
+    }
+};
+
+namespace detail {
+
+// Handlers without integer callbacks receive every number through onNumber
+template <typename H, typename = void>
+struct HasOnInteger : std::false_type {};
+template <typename H>
+struct HasOnInteger<H, std::void_t<decltype(std::declval<H&>().onInteger(int64_t()))>> : std::true_type {};
+
+template <typename H, typename = void>
+struct HasOnUnsigned : std::false_type {};
+template <typename H>
+struct HasOnUnsigned<H, std::void_t<decltype(std::declval<H&>().onUnsigned(uint64_t()))>> : std::true_type {};
+
+template <typename Handler>
+bool reportNumber(Handler& handler, const NumberValue& number) {
+    switch (number.kind) {
+        case NumberValue::Kind::Int64:
+            if constexpr (HasOnInteger<Handler>::value) {
+                return handler.onInteger(number.i);
+            } else {
+                return handler.onNumber(static_cast<double>(number.i));
+            }
+        case NumberValue::Kind::UInt64:
+            if constexpr (HasOnUnsigned<Handler>::value) {
+                return handler.onUnsigned(number.u);
+            } else {
+                return handler.onNumber(static_cast<double>(number.u));
+            }
+        default:
+            return handler.onNumber(number.d);
+    }
+}
+
+} // namespace detail
+
+// Reader that drives a handler from the lexer token stream
+//
+// The grammar (detail::parseGrammar, shared with validate()) runs as a loop
+// over an explicit stack of open containers, so nesting depth costs heap
+// memory rather than C++ stack and the reader can run on small fiber or
+// coroutine stacks. Documents nested deeper than
+// `maxDepth` are rejected with a ParserError.
+//
+// `Handler` is any type with the SaxHandler callbacks; a concrete (or final)
+// handler type lets the compiler inline them. Grammar errors throw
+// ParserError; a handler returning false makes parse() return false.
+template <typename Handler>
+class SaxReader {
+public:
+    SaxReader(JsonLexer& lexer, Handler& handler, size_t maxDepth = kDefaultMaxDepth)
+        : SaxReader(lexer, handler, ownBuffers_, maxDepth) {}
+
+    // With statistics compiled in, token counts, lexing/number/string time,
+    // depth and container sizes are added to `stats` if it is not null
+    SaxReader(JsonLexer& lexer, Handler& handler, SaxBuffers& buffers,
+              size_t maxDepth = kDefaultMaxDepth, ParseStats* stats = nullptr)
+        : lexer_(lexer), handler_(handler), buffers_(buffers), maxDepth_(maxDepth), stats_(stats) {
+        advance();
+    }
+
+    SaxReader(const SaxReader&) = delete;
+    SaxReader& operator=(const SaxReader&) = delete;
+
+    // Parse one complete document; returns false if the handler stopped early
+    bool parse();
+
+    // Parse the members of an array or object whose brackets lie outside
+    // the input: "v, v, ..." or "\"k\": v, ...", up to the end of input. The
+    // handler sees no start or end event for that container, and nesting
+    // inside it counts from depth 1. Used to parse one piece of a document
+    // split at its top-level commas. A closing bracket for that container,
+    // or anything else left before the end of input, throws ParserError.
+    bool parseMembers(bool isObject);
+
+private:
+    using Frame = SaxBuffers::Frame;
+
+    template <typename Actions>
+    friend bool detail::parseGrammar(Actions& actions, size_t base);
+    template <typename Actions>
+    friend bool detail::parseMemberStart(Actions& actions);
+
+    JsonLexer& lexer_;
+    Handler& handler_;
+    SaxBuffers ownBuffers_;
+    SaxBuffers& buffers_;
+    size_t maxDepth_;
+    ParseStats* stats_;
+    Token current_;
+
+    bool advance() {
+        PhaseTimer timer(stats_, ParsePhase::Lexing);
+        current_ = lexer_.nextToken();
+        if constexpr (kStatsEnabled) {
+            if (stats_) {
+                stats_->tokens[static_cast<size_t>(current_.type)]++;
+            }
+        }
+        return true;
+    }
+    std::string errorMessage(std::string_view message) const;
+    std::string_view decode(const Token& token);
+    void checkDepth() const;
+
+    // Grammar actions (see detail::parseGrammar); errors throw ParserError
+    const Token& token() const { return current_; }
+    size_t depth() const { return buffers_.stack.size(); }
+    bool topIsObject() const { return buffers_.stack.back().isObject; }
+    bool startContainer(bool isObject);
+    bool push(bool isObject) {
+        buffers_.stack.push_back(Frame{isObject, 0});
+        return true;
+    }
+    size_t pop();
+    bool endContainer(bool isObject, size_t count) {
+        return isObject ? handler_.onEndObject(count) : handler_.onEndArray(count);
+    }
+    bool member() {
+        buffers_.stack.back().count++;
+        return true;
+    }
+    bool key();
+    bool string();
+    bool number();
+    bool boolean(bool b) {
+        advance();
+        return handler_.onBoolean(b);
+    }
+    bool null() {
+        advance();
+        return handler_.onNull();
+    }
+    bool fail(GrammarError error);
+};
+
+// Parse `input` and report it to `handler`; returns false if the handler stopped early
+template <typename Handler>
+bool parseSax(std::string_view input, Handler& handler,
+              const ParseOptions& options = ParseOptions()) {
+    checkInput(input, options);
+    JsonLexer lexer(input, ScanMode::Indexed);
+    SaxReader<Handler> reader(lexer, handler, options.maxDepth);
+    return reader.parse();
+}
+
+// Implementation
+
+template <typename Handler>
+bool SaxReader<Handler>::parse() {
+    buffers_.stack.clear();
+    if (!detail::parseGrammar(*this, 0)) {
+        return false;
+    }
+    if (current_.type != TokenType::END_OF_FILE) {
+        throw ParserError("Expected end of file");
+    }
+    return true;
+}
+
+template <typename Handler>
+bool SaxReader<Handler>::parseMembers(bool isObject) {
+    buffers_.stack.clear();
+    checkDepth();
+    push(isObject);
+    if (!detail::parseMemberStart(*this) || !detail::parseGrammar(*this, 1)) {
+        return false;
+    }
+    if (current_.type != TokenType::END_OF_FILE) {
+        throw ParserError(errorMessage("Expected end of input after members"));
+    }
+    return true;
+}
+
+template <typename Handler>
+std::string SaxReader<Handler>::errorMessage(std::string_view message) const {
+    std::stringstream ss;
+    SourceLocation location = lexer_.locate(current_.offset);
+    ss << message << " at line " << location.line << ", column " << location.column;
+    return ss.str();
+}
+
+template <typename Handler>
+std::string_view SaxReader<Handler>::decode(const Token& token) {
+    if (!token.escaped) {
+        return token.value;
+    }
+    PhaseTimer timer(stats_, ParsePhase::Strings, token.value.size());
+    buffers_.scratch.clear();
+    JsonLexer::unescape(token.value, buffers_.scratch);
+    return buffers_.scratch;
+}
+
+template <typename Handler>
+void SaxReader<Handler>::checkDepth() const {
+    if (buffers_.stack.size() >= maxDepth_) {
+        throw ParserError(errorMessage("Maximum nesting depth exceeded"));
+    }
+    if constexpr (kStatsEnabled) {
+        if (stats_) {
+            stats_->maxDepth = std::max(stats_->maxDepth, buffers_.stack.size() + 1);
+        }
+    }
+}
+
+template <typename Handler>
+bool SaxReader<Handler>::startContainer(bool isObject) {
+    checkDepth();
+    return isObject ? handler_.onStartObject() : handler_.onStartArray();
+}
+
+template <typename Handler>
+size_t SaxReader<Handler>::pop() {
+    size_t count = buffers_.stack.back().count;
+    buffers_.stack.pop_back();
+    if constexpr (kStatsEnabled) {
+        if (stats_) {
+            stats_->largestContainer = std::max(stats_->largestContainer, count);
+        }
+    }
+    return count;
+}
+
+template <typename Handler>
+bool SaxReader<Handler>::key() {
+    Token key = current_;
+    advance();
+    return handler_.onKey(decode(key));
+}
+
+template <typename Handler>
+bool SaxReader<Handler>::string() {
+    Token token = current_;
+    advance();
+    return handler_.onString(decode(token));
+}
+
+template <typename Handler>
+bool SaxReader<Handler>::number() {
+    NumberValue value;
+    {
+        PhaseTimer timer(stats_, ParsePhase::Numbers, current_.value.size());
+        value = json::parseNumber(current_.value);
+    }
+    advance();
+    return detail::reportNumber(handler_, value);
+}
+
+template <typename Handler>
+bool SaxReader<Handler>::fail(GrammarError error) {
+    switch (error) {
+        case GrammarError::ExpectedValue:
+            if (current_.type == TokenType::ERROR) {
+                throw ParserError(errorMessage(current_.value));
+            }
+            throw ParserError("Unexpected token");
+        case GrammarError::ExpectedKey:
+            throw ParserError(errorMessage("Expected string key"));
+        case GrammarError::ExpectedColon:
+            throw ParserError(errorMessage("Expected ':' after key"));
+        case GrammarError::ExpectedObjectEnd:
+            throw ParserError(errorMessage("Expected '}' after object"));
+        case GrammarError::ExpectedArrayEnd:
+            throw ParserError(errorMessage("Expected ']' after array"));
+        default:
+            throw ParserError(errorMessage("Expected ',' or end of input after member"));
+    }
+}
+
+} // namespace json
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "json_lexer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define JSON_STATS_RDTSC 1
+#endif
+
+namespace json {
+
+// Parse statistics are collected only when the library is built with
+// -DJSONPARSER_ENABLE_STATS=ON; otherwise every counter stays zero and the
+// instrumentation compiles away.
+#ifdef JSONPARSER_ENABLE_STATS
+constexpr bool kStatsEnabled = true;
+#else
+constexpr bool kStatsEnabled = false;
+#endif
+
+// Where parse time goes
+enum class ParsePhase {
+    Validation,  // UTF-8 check (ParseOptions::validateUtf8)
+    Indexing,    // Structural index build
+    Lexing,      // Tokenizing
+    Numbers,     // Number conversion
+    Strings,     // Decoding escaped strings
+    Building     // Everything else: grammar and value construction
+};
+
+constexpr size_t kParsePhaseCount = static_cast<size_t>(ParsePhase::Building) + 1;
+constexpr size_t kTokenTypeCount = static_cast<size_t>(TokenType::ERROR) + 1;
+
+inline const char* phaseName(ParsePhase phase) {
+    switch (phase) {
+        case ParsePhase::Validation: return "validation";
+        case ParsePhase::Indexing: return "indexing";
+        case ParsePhase::Lexing: return "lexing";
+        case ParsePhase::Numbers: return "numbers";
+        case ParsePhase::Strings: return "strings";
+        default: return "building";
+    }
+}
+
+// Timestamp counter (rdtsc on x86, nanoseconds elsewhere)
+inline uint64_t readCycleCounter() {
+#ifdef JSON_STATS_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Counters for one parse, or a sum of several
+//
+// JsonParser::stats() describes its last parse; a parse that throws is
+// counted up to the error. Statistics from different parsers or threads are
+// combined with +=, so each thread can keep its own and merge at the end.
+struct ParseStats {
+    uint64_t parses = 0;
+    uint64_t cycles[kParsePhaseCount] = {};   // readCycleCounter() ticks per phase
+    uint64_t bytes[kParsePhaseCount] = {};    // Input bytes handled by each phase
+    uint64_t tokens[kTokenTypeCount] = {};    // Tokens by TokenType
+    // Heap blocks requested for the result: strings longer than the
+    // small-string buffer, array and object growth, Document arena blocks
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    size_t maxDepth = 0;          // Deepest container nesting
+    size_t largestContainer = 0;  // Most elements or members in one container
+
+    uint64_t cyclesIn(ParsePhase phase) const { return cycles[static_cast<size_t>(phase)]; }
+    uint64_t bytesIn(ParsePhase phase) const { return bytes[static_cast<size_t>(phase)]; }
+    uint64_t tokenCount(TokenType type) const { return tokens[static_cast<size_t>(type)]; }
+
+    uint64_t totalCycles() const {
+        uint64_t total = 0;
+        for (uint64_t c : cycles) {
+            total += c;
+        }
+        return total;
+    }
+
+    ParseStats& operator+=(const ParseStats& other) {
+        parses += other.parses;
+        for (size_t i = 0; i < kParsePhaseCount; ++i) {
+            cycles[i] += other.cycles[i];
+            bytes[i] += other.bytes[i];
+        }
+        for (size_t i = 0; i < kTokenTypeCount; ++i) {
+            tokens[i] += other.tokens[i];
+        }
+        allocations += other.allocations;
+        allocatedBytes += other.allocatedBytes;
+        maxDepth = std::max(maxDepth, other.maxDepth);
+        largestContainer = std::max(largestContainer, other.largestContainer);
+        return *this;
+    }
+};
+
+// Adds the ticks spent in its scope to one phase; does nothing when
+// `stats` is null or statistics are compiled out
+class PhaseTimer {
+public:
+    PhaseTimer(ParseStats* stats, ParsePhase phase, size_t bytes = 0) {
+        if constexpr (kStatsEnabled) {
+            if (stats) {
+                stats_ = stats;
+                phase_ = static_cast<size_t>(phase);
+                stats->bytes[phase_] += bytes;
+                start_ = readCycleCounter();
+            }
+        }
+    }
+
+    ~PhaseTimer() {
+        if constexpr (kStatsEnabled) {
+            if (stats_) {
+                stats_->cycles[phase_] += readCycleCounter() - start_;
+            }
+        }
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    ParseStats* stats_ = nullptr;
+    size_t phase_ = 0;
+    uint64_t start_ = 0;
+};
+
+} // namespace json
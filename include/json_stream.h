@@ -0,0 +1,105 @@
+#pragma once
+
+#include "json_value.h"
+#include "json_lexer.h"
+#include "json_parser.h"
+#include "json_sax.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Incremental (push) parser
+//
+// Input is supplied in arbitrary chunks through feed(); finish() marks the
+// end of the input and returns the parsed value. Tokens split across chunk
+// boundaries - in the middle of a string, number, literal or \u escape - are
+// carried over in a small buffer, so apart from the value being built the
+// parser holds one partial token and one frame per open container.
+//
+// Errors are reported with the same ParserError messages as JsonParser.
+//
+// By default the parser builds a JsonValue. Constructed with a SaxHandler it
+// only reports events instead, so memory stays constant however large the
+// input is.
+//
+// options.maxDepth limits container nesting as in JsonParser;
+// options.validateUtf8 is not applied, since chunks may split a sequence.
+class StreamingParser {
+public:
+    explicit StreamingParser(const ParseOptions& options = ParseOptions());
+    explicit StreamingParser(SaxHandler& handler, const ParseOptions& options = ParseOptions());
+
+    StreamingParser(const StreamingParser&) = delete;
+    StreamingParser& operator=(const StreamingParser&) = delete;
+
+    // Consume the next piece of input; the chunk need not outlive the call
+    void feed(std::string_view chunk);
+
+    // Signal end of input and return the document (null in handler mode);
+    // the parser can then be reused
+    JsonValue finish();
+
+    // Discard all state
+    void reset();
+
+    // Bytes fed so far
+    size_t bytesConsumed() const { return base_.offset; }
+
+    // True once the handler returned false; further input is ignored
+    bool stopped() const { return stopped_; }
+
+private:
+    enum class State : uint8_t {
+        Value,            // After ',' in an array / ':' in an object
+        FirstValueOrEnd,  // After '['
+        FirstKeyOrEnd,    // After '{'
+        Key,              // After ',' in an object
+        Colon,            // After a key
+        CommaOrEnd        // After a member or element
+    };
+
+    struct Frame {
+        bool isObject;
+        State state;
+        size_t count;
+    };
+
+    // Absolute position of the first byte of a piece of text
+    struct Position {
+        size_t offset = 0;
+        size_t line = 1;
+        size_t lineStart = 0;
+    };
+
+    ValueBuilder builder_;
+    SaxHandler* handler_;
+    std::vector<Frame> stack_;
+    size_t maxDepth_;
+    bool hasRoot_;
+    bool stopped_;
+    std::string scratch_;
+
+    std::string pending_;      // Partial token carried over from the previous chunk
+    bool pendingString_;
+    Position pendingBase_;
+    Position base_;            // Start of the next chunk
+
+    std::string_view segment_; // Text currently being lexed, for error locations
+    Position segmentBase_;
+
+    void lexSegment(std::string_view text, const Position& base, bool mayContinue);
+    size_t findPendingEnd(std::string_view chunk) const;
+    void onToken(const Token& token);
+    void beginValue(const Token& token);
+    void valueDone();
+    void closeContainer();
+    void report(bool proceed) { stopped_ = stopped_ || !proceed; }
+    std::string_view decode(const Token& token);
+    [[noreturn]] void fail(const std::string& message, const Token& token) const;
+
+    static Position advancePosition(Position position, std::string_view text, size_t count);
+};
+
+} // namespace json
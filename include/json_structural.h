@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Instruction set used by the structural scanner
+enum class SimdLevel {
+    Auto,    // Best kernel supported by the running CPU
+    Scalar,  // Portable byte-at-a-time fallback
+    SSE2,    // 4 x 16 bytes per block
+    AVX2,    // 2 x 32 bytes per block
+    AVX512   // 1 x 64 bytes per block (AVX-512BW)
+};
+
+// Best kernel supported by the running CPU
+SimdLevel detectSimdLevel();
+
+// Structural index (stage 1)
+//
+// A first pass over the input that records, in order, the offset of every
+// structural character outside strings ({ } [ ] , :), every unescaped quote
+// (both the opening and the closing one) and the first byte of every scalar
+// (number or literal). Whitespace and string contents never appear in the
+// index, so a lexer driven by it can jump straight from token to token.
+class StructuralIndex {
+public:
+    // Largest input the index can describe (offsets are 32-bit)
+    static constexpr size_t kMaxInputSize = UINT32_MAX;
+
+    // Build the index for `input`, reusing the previous allocation.
+    // An unsupported `level` falls back to the best supported one.
+    void build(std::string_view input, SimdLevel level = SimdLevel::Auto);
+
+    const std::vector<uint32_t>& positions() const { return positions_; }
+    size_t size() const { return positions_.size(); }
+    uint32_t operator[](size_t i) const { return positions_[i]; }
+
+    // True if the input ended inside a string
+    bool unclosedString() const { return unclosedString_; }
+
+    // Kernel used by the last build()
+    SimdLevel level() const { return level_; }
+
+private:
+    std::vector<uint32_t> positions_;
+    bool unclosedString_ = false;
+    SimdLevel level_ = SimdLevel::Scalar;
+};
+
+// Byte scanning kernels (same runtime dispatch as the structural index)
+
+// Offset of the first '"', '\\' or control character (< 0x20) in
+// [data, data + size), or `size` if there is none
+size_t findStringSpecial(const char* data, size_t size);
+
+// Check that `input` is well-formed UTF-8 (RFC 3629: no overlong forms,
+// surrogates or code points above U+10FFFF). ASCII runs are skipped a whole
+// vector at a time. On failure the offset of the offending sequence is
+// stored in `errorOffset` if given.
+bool validateUtf8(std::string_view input, size_t* errorOffset = nullptr);
+
+} // namespace json
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace json {
+
+// Work-stealing thread pool
+//
+// Every worker owns a deque: it takes its own tasks from the back (most
+// recently queued, still warm in cache) and steals from the front of the
+// other deques when it runs dry. A thread waiting in parallelFor() runs
+// queued tasks itself instead of blocking, so nested parallel loops cannot
+// starve the pool.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // `threads` workers; 0 means one per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    // Queue a task. From a worker thread it goes to that worker's own
+    // deque, otherwise the deques are filled round-robin.
+    void submit(Task task);
+
+    // Run body(0) ... body(count - 1) on the pool and wait for all of them.
+    // The first exception thrown by a call is rethrown here once every
+    // call has finished.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool runOne(size_t preferred);
+    bool takeTask(size_t preferred, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> nextQueue_{0};
+    std::atomic<bool> stop_{false};
+
+    std::mutex sleepMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable taskFinished_;
+};
+
+} // namespace json
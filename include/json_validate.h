@@ -0,0 +1,71 @@
+#pragma once
+
+#include "json_parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace json {
+
+// Why validate() rejected its input
+enum class ValidationError {
+    None,
+    // Lexical errors
+    UnexpectedCharacter,  // Byte that cannot start a token
+    InvalidLiteral,       // Misspelled true, false or null
+    InvalidNumber,        // Missing digits in a number
+    NumberOutOfRange,     // Number that does not fit in a double
+    InvalidEscape,        // Bad backslash or \u escape in a string
+    ControlCharacter,     // Unescaped control character in a string
+    UnterminatedString,
+    InvalidUtf8,          // Only with ValidateOptions::validateUtf8
+    // Grammar errors
+    ExpectedValue,        // A value was expected (this includes empty input)
+    ExpectedKey,          // An object member must start with a string key
+    ExpectedColon,
+    ExpectedObjectEnd,    // ',' or '}' expected after an object member
+    ExpectedArrayEnd,     // ',' or ']' expected after an array element
+    TrailingContent,      // More input after the top-level value
+    // Limits
+    TooLarge,
+    TooDeep,
+    StringTooLong,
+    TooManyMembers
+};
+
+// Short English description of an error
+const char* validationMessage(ValidationError error);
+
+// Limits and checks applied by validate()
+struct ValidateOptions {
+    size_t maxSize = SIZE_MAX;           // Input bytes
+    size_t maxDepth = kDefaultMaxDepth;  // Nesting of arrays and objects
+    // Raw bytes between the quotes of a string or key, before unescaping
+    size_t maxStringLength = SIZE_MAX;
+    // Elements of one array or members of one object
+    size_t maxMembers = SIZE_MAX;
+    bool validateUtf8 = false;           // As ParseOptions::validateUtf8
+};
+
+// Outcome of validate(): the first error and the byte offset where it was
+// found (the start of the offending token, or of the member or container
+// that broke a limit)
+struct ValidationResult {
+    ValidationError error = ValidationError::None;
+    size_t offset = 0;
+
+    bool ok() const { return error == ValidationError::None; }
+    explicit operator bool() const { return ok(); }
+};
+
+// Check that `input` is one well-formed JSON document without building it
+//
+// Runs JsonParser's lexer and grammar loop (detail::parseGrammar, also
+// behind SaxReader), so with the default limits it accepts exactly the
+// documents JsonParser::parse() accepts, but it constructs no values,
+// decodes no strings and never throws. It does no
+// heap allocation unless `maxDepth` is raised above kDefaultMaxDepth and
+// the input actually nests deeper, in which case one buffer is allocated.
+ValidationResult validate(std::string_view input, const ValidateOptions& options = ValidateOptions()) noexcept;
+
+} // namespace json
@@ -1,28 +1,97 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
 #include <variant>
 #include <memory>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
 
 namespace json {
 
+class JsonValue;
+
+// Insertion-ordered object
+//
+// Members are kept in one contiguous vector in the order they were added, so
+// iteration is cache friendly and serialization reproduces the original key
+// order. Small objects are searched linearly; above kIndexThreshold members
+// an open-addressing hash index (member position plus a hash tag per slot)
+// makes lookups O(1).
+class JsonObject {
+public:
+    using value_type = std::pair<std::string, JsonValue>;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    static constexpr size_t kIndexThreshold = 16;
+
+    size_t size() const { return members_.size(); }
+    bool empty() const { return members_.empty(); }
+    size_t capacity() const { return members_.capacity(); }
+    void reserve(size_t count);
+    void clear();
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    // Lookup; at() throws std::out_of_range like std::map::at
+    JsonValue& at(std::string_view key);
+    const JsonValue& at(std::string_view key) const;
+    iterator find(std::string_view key);
+    const_iterator find(std::string_view key) const;
+    size_t count(std::string_view key) const { return findIndex(key) != npos ? 1 : 0; }
+    bool contains(std::string_view key) const { return findIndex(key) != npos; }
+
+    // Insert a default value if the key is missing
+    JsonValue& operator[](std::string key);
+
+    // Insert unless the key already exists; returns the member and whether it was added
+    std::pair<iterator, bool> emplace(std::string key, JsonValue value);
+    std::pair<iterator, bool> insert(value_type member);
+
+    // Remove a member, preserving the order of the others
+    size_t erase(std::string_view key);
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    std::vector<value_type> members_;
+    std::vector<uint64_t> index_;  // Slot: member position + 1 (low 32 bits), hash tag (high 32 bits)
+
+    static size_t hashKey(std::string_view key);
+    size_t findIndex(std::string_view key) const;
+    size_t findIndex(std::string_view key, size_t hash) const;
+    size_t append(std::string&& key, JsonValue&& value, size_t hash);
+    void indexInsert(size_t position, size_t hash);
+    void rebuildIndex();
+};
+
 class JsonValue {
 public:
     // Supported data types
-    using Object = std::map<std::string, JsonValue>;
+    using Object = JsonObject;
     using Array = std::vector<JsonValue>;
     using String = std::string;
     using Number = double;
+    using Integer = int64_t;
+    using Unsigned = uint64_t;
     using Boolean = bool;
     using Null = std::nullptr_t;
 
     // Constructors
     JsonValue() : value_(Null()) {}
+    JsonValue(const char* str) : value_(String(str)) {}
     JsonValue(const String& str) : value_(str) {}
     JsonValue(String&& str) : value_(std::move(str)) {}
     JsonValue(Number num) : value_(num) {}
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    JsonValue(T num)
+        : value_(std::in_place_type<std::conditional_t<std::is_signed_v<T>, Integer, Unsigned>>, num) {}
     JsonValue(Boolean b) : value_(b) {}
     JsonValue(Null) : value_(nullptr) {}
     JsonValue(const Object& obj) : value_(obj) {}
@@ -30,11 +99,24 @@ public:
     JsonValue(const Array& arr) : value_(arr) {}
     JsonValue(Array&& arr) : value_(std::move(arr)) {}
 
+    JsonValue(const JsonValue&) = default;
+    JsonValue(JsonValue&&) noexcept = default;
+    JsonValue& operator=(const JsonValue&) = default;
+    JsonValue& operator=(JsonValue&&) noexcept = default;
+
+    // Nested containers are released from an explicit worklist, so dropping
+    // a deeply nested value does not recurse
+    ~JsonValue();
+
     // Type checks
     bool isObject() const { return std::holds_alternative<Object>(value_); }
     bool isArray() const { return std::holds_alternative<Array>(value_); }
     bool isString() const { return std::holds_alternative<String>(value_); }
-    bool isNumber() const { return std::holds_alternative<Number>(value_); }
+    bool isNumber() const { return isDouble() || isInt(); }
+    bool isDouble() const { return std::holds_alternative<Number>(value_); }
+    bool isInt() const {
+        return std::holds_alternative<Integer>(value_) || std::holds_alternative<Unsigned>(value_);
+    }
     bool isBoolean() const { return std::holds_alternative<Boolean>(value_); }
     bool isNull() const { return std::holds_alternative<Null>(value_); }
 
@@ -42,14 +124,50 @@ public:
     const Object& asObject() const { return std::get<Object>(value_); }
     const Array& asArray() const { return std::get<Array>(value_); }
     const String& asString() const { return std::get<String>(value_); }
-    Number asNumber() const { return std::get<Number>(value_); }
+    Number asNumber() const;
+    // Exact integer access; throws std::out_of_range if the stored integer
+    // does not fit the requested type
+    Integer asInt64() const;
+    Unsigned asUint64() const;
     Boolean asBoolean() const { return std::get<Boolean>(value_); }
 
-    // Serialization
+    // Call `visitor` with the stored alternative (Object, Array, String,
+    // Number, Boolean, Null, Integer or Unsigned)
+    template <typename Visitor>
+    decltype(auto) visit(Visitor&& visitor) const {
+        return std::visit(std::forward<Visitor>(visitor), value_);
+    }
+
+    // Deep comparison by content: numbers compare by exact value (1 == 1.0)
+    // and object members in any order. Iterative; stops at the first
+    // difference, checking types and sizes before descending.
+    bool operator==(const JsonValue& other) const;
+    bool operator!=(const JsonValue& other) const { return !(*this == other); }
+
+    // Serialization (compact); see JsonWriter for sinks and pretty-printing
     std::string toString() const;
 
 private:
-    std::variant<Object, Array, String, Number, Boolean, Null> value_;
+    std::variant<Object, Array, String, Number, Boolean, Null, Integer, Unsigned> value_;
+
+    bool isNonEmptyContainer() const;
+    bool hasNestedContainers() const;
+    void detachNestedContainers(std::vector<JsonValue>& pending);
 };
 
-} // namespace json 
\ No newline at end of file
+inline JsonObject::iterator JsonObject::begin() { return members_.data(); }
+inline JsonObject::iterator JsonObject::end() { return members_.data() + members_.size(); }
+inline JsonObject::const_iterator JsonObject::begin() const { return members_.data(); }
+inline JsonObject::const_iterator JsonObject::end() const { return members_.data() + members_.size(); }
+
+inline JsonObject::iterator JsonObject::find(std::string_view key) {
+    size_t i = findIndex(key);
+    return i == npos ? end() : begin() + i;
+}
+
+inline JsonObject::const_iterator JsonObject::find(std::string_view key) const {
+    size_t i = findIndex(key);
+    return i == npos ? end() : begin() + i;
+}
+
+} // namespace json
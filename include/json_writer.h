@@ -0,0 +1,151 @@
+#pragma once
+
+#include "json_value.h"
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Writer exception
+class WriterError : public std::runtime_error {
+public:
+    explicit WriterError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+// Output destination for JsonWriter
+//
+// The writer hands data over in blocks of at most its buffer size. write()
+// returns false to abort serialization; a sink that blocks until it can
+// accept more data applies back-pressure to the writer.
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+    virtual bool write(const char* data, size_t size) = 0;
+};
+
+// Appends to a std::FILE*
+class FileSink : public OutputSink {
+public:
+    explicit FileSink(std::FILE* file) : file_(file) {}
+    bool write(const char* data, size_t size) override;
+
+private:
+    std::FILE* file_;
+};
+
+// Writes to a file descriptor, retrying partial writes
+class FdSink : public OutputSink {
+public:
+    explicit FdSink(int fd) : fd_(fd) {}
+    bool write(const char* data, size_t size) override;
+
+private:
+    int fd_;
+};
+
+// Forwards every block to a callback
+class CallbackSink : public OutputSink {
+public:
+    using Callback = std::function<bool(const char* data, size_t size)>;
+
+    explicit CallbackSink(Callback callback) : callback_(std::move(callback)) {}
+    bool write(const char* data, size_t size) override { return callback_(data, size); }
+
+private:
+    Callback callback_;
+};
+
+// Serialization options
+struct WriterOptions {
+    bool pretty = false;  // Newlines and indentation
+    int indent = 2;       // Spaces per level when pretty
+};
+
+// Streaming JSON writer
+//
+// Output goes either straight into a std::string or through a fixed-size
+// buffer into an OutputSink. Values can be written whole (write) or built
+// up event by event (beginObject/key/.../endObject); commas, indentation
+// and escaping are handled by the writer. Nothing is allocated per value.
+// String bytes pass through as UTF-8; only '"', '\\' and control characters
+// are escaped.
+// Several top-level values are separated by newlines.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out, const WriterOptions& options = WriterOptions());
+    explicit JsonWriter(OutputSink& sink, const WriterOptions& options = WriterOptions(),
+                        size_t bufferSize = 64 * 1024);
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    // Write a complete value
+    void write(const JsonValue& value);
+
+    // Event interface
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(std::string_view name);
+    void string(std::string_view str);
+    void number(double num);
+    void integer(int64_t num);
+    void unsignedInteger(uint64_t num);
+    void boolean(bool b);
+    void null();
+
+    // Hand buffered output to the sink; throws WriterError if it refuses
+    void flush();
+
+private:
+    struct Frame {
+        bool isObject;
+        size_t count;
+    };
+
+    // Position inside a container while write() walks a JsonValue
+    struct Cursor {
+        const JsonValue* container;
+        size_t next;
+    };
+
+    std::string* target_;  // Where output is appended
+    std::string buffer_;   // Staging buffer in sink mode
+    OutputSink* sink_;
+    size_t bufferSize_;
+    WriterOptions options_;
+    std::vector<Frame> stack_;
+    std::vector<Cursor> cursors_;
+    bool afterKey_;
+    bool hasRoot_;
+
+    void put(char c) {
+        target_->push_back(c);
+    }
+    void put(const char* data, size_t size) {
+        target_->append(data, size);
+    }
+    // Like put(), but in sink mode flushes whenever the buffer fills, for
+    // runs that may be much longer than the buffer
+    void putRun(const char* data, size_t size);
+    void maybeFlush() {
+        if (sink_ && buffer_.size() >= bufferSize_) {
+            flush();
+        }
+    }
+
+    void beforeValue();
+    void newline(size_t depth);
+    void writeEscaped(std::string_view str);
+    void writeValue(const JsonValue& root);
+    void writeScalar(const JsonValue& value);
+};
+
+} // namespace json
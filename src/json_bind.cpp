@@ -0,0 +1,178 @@
+#include "json_bind.h"
+#include <sstream>
+
+namespace json {
+
+BindReader::BindReader(std::string_view input, const ParseOptions& options)
+    : input_(input), lexer_(input), options_(options) {
+    checkInput(input, options);
+    advance();
+}
+
+void BindReader::fail(std::string_view message) const {
+    std::stringstream ss;
+    SourceLocation location = lexer_.locate(current_.offset);
+    ss << message << " at line " << location.line << ", column " << location.column;
+    throw ParserError(ss.str());
+}
+
+void BindReader::unexpected(const char* expected) const {
+    // 词法错误优先于类型不匹配
+    if (current_.type == TokenType::ERROR) {
+        fail(current_.value);
+    }
+    fail(expected);
+}
+
+bool BindReader::readNull() {
+    if (current_.type != TokenType::NULL_) {
+        return false;
+    }
+    advance();
+    return true;
+}
+
+bool BindReader::readBoolean() {
+    if (current_.type != TokenType::TRUE && current_.type != TokenType::FALSE) {
+        unexpected("Expected boolean");
+    }
+    bool value = current_.type == TokenType::TRUE;
+    advance();
+    return value;
+}
+
+NumberValue BindReader::number() const {
+    return parseNumber(current_.value);
+}
+
+std::string_view BindReader::readString() {
+    if (current_.type != TokenType::STRING) {
+        unexpected("Expected string");
+    }
+    Token token = current_;
+    advance();
+    if (!token.escaped) {
+        return token.value;
+    }
+    scratch_.clear();
+    JsonLexer::unescape(token.value, scratch_);
+    return scratch_;
+}
+
+void BindReader::enter() {
+    if (depth_ >= options_.maxDepth) {
+        fail("Maximum nesting depth exceeded");
+    }
+    depth_++;
+    advance();
+}
+
+void BindReader::beginObject() {
+    if (current_.type != TokenType::LEFT_BRACE) {
+        unexpected("Expected object");
+    }
+    enter();
+}
+
+bool BindReader::nextMember(size_t& count, std::string_view& key) {
+    if (current_.type == TokenType::RIGHT_BRACE) {
+        depth_--;
+        advance();
+        return false;
+    }
+    if (count > 0) {
+        if (current_.type != TokenType::COMMA) {
+            fail("Expected '}' after object");
+        }
+        advance();
+    }
+    if (current_.type != TokenType::STRING) {
+        fail("Expected string key");
+    }
+    key = readString();
+    if (current_.type != TokenType::COLON) {
+        fail("Expected ':' after key");
+    }
+    advance();
+    count++;
+    return true;
+}
+
+void BindReader::beginArray() {
+    if (current_.type != TokenType::LEFT_BRACKET) {
+        unexpected("Expected array");
+    }
+    enter();
+}
+
+bool BindReader::nextElement(size_t& count) {
+    if (current_.type == TokenType::RIGHT_BRACKET) {
+        depth_--;
+        advance();
+        return false;
+    }
+    if (count > 0) {
+        if (current_.type != TokenType::COMMA) {
+            fail("Expected ']' after array");
+        }
+        advance();
+    }
+    count++;
+    return true;
+}
+
+void BindReader::skipValue() {
+    // 只需校验语法，用显式栈代替递归
+    size_t base = depth_;
+    do {
+        switch (current_.type) {
+            case TokenType::LEFT_BRACE:
+                enter();
+                skipStack_.push_back(SkipFrame{true, 0});
+                break;
+            case TokenType::LEFT_BRACKET:
+                enter();
+                skipStack_.push_back(SkipFrame{false, 0});
+                break;
+            case TokenType::STRING:
+            case TokenType::NUMBER:
+            case TokenType::TRUE:
+            case TokenType::FALSE:
+            case TokenType::NULL_:
+                advance();
+                break;
+            case TokenType::ERROR:
+                fail(current_.value);
+            default:
+                throw ParserError("Unexpected token");
+        }
+
+        // 读取下一个成员/元素的前缀，关闭已结束的容器
+        while (depth_ > base) {
+            SkipFrame& top = skipStack_.back();
+            std::string_view key;
+            if (top.isObject ? nextMember(top.count, key) : nextElement(top.count)) {
+                break;
+            }
+            skipStack_.pop_back();
+        }
+    } while (depth_ > base);
+}
+
+JsonValue BindReader::readValue() {
+    // 先跳过以校验语法，再把这段文本交给解析器
+    size_t begin = current_.offset;
+    skipValue();
+    size_t end = current_.type == TokenType::END_OF_FILE ? input_.size() : current_.offset;
+    ParseOptions options = options_;
+    options.validateUtf8 = false;
+    return JsonParser(input_.substr(begin, end - begin), options).parse();
+}
+
+void BindReader::finish() {
+    if (current_.type != TokenType::END_OF_FILE) {
+        throw ParserError("Expected end of file");
+    }
+}
+
+} // namespace json
@@ -0,0 +1,421 @@
+#include "json_cbor.h"
+#include "json_structural.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace json {
+
+namespace {
+
+// 主类型
+constexpr uint8_t kUnsigned = 0;
+constexpr uint8_t kNegative = 1;
+constexpr uint8_t kBytes = 2;
+constexpr uint8_t kText = 3;
+constexpr uint8_t kArray = 4;
+constexpr uint8_t kMap = 5;
+constexpr uint8_t kTag = 6;
+constexpr uint8_t kSimple = 7;
+
+// 主类型 7 的附加信息
+constexpr uint8_t kFalse = 20;
+constexpr uint8_t kTrue = 21;
+constexpr uint8_t kNull = 22;
+constexpr uint8_t kUndefined = 23;
+constexpr uint8_t kHalf = 25;
+constexpr uint8_t kFloat = 26;
+constexpr uint8_t kDouble = 27;
+constexpr uint8_t kIndefinite = 31;
+
+void putBigEndian(std::string& out, uint64_t value, int bytes) {
+    char buffer[8];
+    for (int i = bytes - 1; i >= 0; --i) {
+        buffer[i] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+    out.append(buffer, static_cast<size_t>(bytes));
+}
+
+// 类型字节加最短的长度编码
+void putHead(std::string& out, uint8_t major, uint64_t argument) {
+    uint8_t type = static_cast<uint8_t>(major << 5);
+    if (argument < 24) {
+        out += static_cast<char>(type | argument);
+    } else if (argument <= 0xff) {
+        out += static_cast<char>(type | 24);
+        putBigEndian(out, argument, 1);
+    } else if (argument <= 0xffff) {
+        out += static_cast<char>(type | 25);
+        putBigEndian(out, argument, 2);
+    } else if (argument <= 0xffffffff) {
+        out += static_cast<char>(type | 26);
+        putBigEndian(out, argument, 4);
+    } else {
+        out += static_cast<char>(type | 27);
+        putBigEndian(out, argument, 8);
+    }
+}
+
+void putText(std::string& out, std::string_view text) {
+    putHead(out, kText, text.size());
+    out.append(text.data(), text.size());
+}
+
+void putDouble(std::string& out, double value) {
+    // 能无损表示为 float 时只占 5 字节
+    float narrow = static_cast<float>(value);
+    if (static_cast<double>(narrow) == value) {
+        uint32_t bits;
+        std::memcpy(&bits, &narrow, sizeof(bits));
+        out += static_cast<char>((kSimple << 5) | kFloat);
+        putBigEndian(out, bits, 4);
+    } else {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        out += static_cast<char>((kSimple << 5) | kDouble);
+        putBigEndian(out, bits, 8);
+    }
+}
+
+void putScalar(std::string& out, const JsonValue& value) {
+    value.visit([&out](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, JsonValue::String>) {
+            putText(out, v);
+        } else if constexpr (std::is_same_v<T, JsonValue::Number>) {
+            putDouble(out, v);
+        } else if constexpr (std::is_same_v<T, JsonValue::Integer>) {
+            if (v >= 0) {
+                putHead(out, kUnsigned, static_cast<uint64_t>(v));
+            } else {
+                putHead(out, kNegative, static_cast<uint64_t>(-(v + 1)));
+            }
+        } else if constexpr (std::is_same_v<T, JsonValue::Unsigned>) {
+            putHead(out, kUnsigned, v);
+        } else if constexpr (std::is_same_v<T, JsonValue::Boolean>) {
+            out += static_cast<char>((kSimple << 5) | (v ? kTrue : kFalse));
+        } else if constexpr (std::is_same_v<T, JsonValue::Null>) {
+            out += static_cast<char>((kSimple << 5) | kNull);
+        }
+    });
+}
+
+double halfToDouble(uint16_t half) {
+    int exponent = (half >> 10) & 0x1f;
+    int mantissa = half & 0x3ff;
+    double value;
+    if (exponent == 0) {
+        value = std::ldexp(mantissa, -24);
+    } else if (exponent == 31) {
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity()
+                              : std::numeric_limits<double>::quiet_NaN();
+    } else {
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+// 逐项读取 CBOR 数据
+class CborReader {
+public:
+    explicit CborReader(std::string_view data, size_t offset = 0) : data_(data), pos_(offset) {}
+
+    size_t position() const { return pos_; }
+    size_t remaining() const { return data_.size() - pos_; }
+
+    struct Head {
+        uint8_t major;
+        uint8_t info;
+        uint64_t argument;
+        size_t offset;  // Offset of the initial byte, for errors
+    };
+
+    Head readHead() {
+        Head head;
+        head.offset = pos_;
+        uint8_t initial = static_cast<uint8_t>(take(1)[0]);
+        head.major = static_cast<uint8_t>(initial >> 5);
+        head.info = static_cast<uint8_t>(initial & 0x1f);
+        if (head.info < 24) {
+            head.argument = head.info;
+        } else if (head.info <= 27) {
+            // 24..27 分别跟 1、2、4、8 字节的大端整数
+            size_t bytes = size_t(1) << (head.info - 24);
+            std::string_view raw = take(bytes);
+            head.argument = 0;
+            for (char c : raw) {
+                head.argument = (head.argument << 8) | static_cast<uint8_t>(c);
+            }
+        } else if (head.info == kIndefinite && head.major >= kBytes && head.major <= kMap) {
+            fail("Indefinite-length items are not supported", head.offset);
+        } else {
+            fail("Invalid additional information", head.offset);
+        }
+        return head;
+    }
+
+    // 字符串内容；先检查长度，避免超大长度溢出
+    std::string_view readPayload(const Head& head) {
+        if (head.argument > remaining()) {
+            fail("Unexpected end of input", data_.size());
+        }
+        return take(static_cast<size_t>(head.argument));
+    }
+
+    // 容器的每个元素至少占 1 字节，长度超过剩余字节数的数据必然被截断
+    size_t readCount(const Head& head, uint64_t itemsPerEntry) {
+        if (head.argument > remaining() / itemsPerEntry) {
+            fail("Unexpected end of input", data_.size());
+        }
+        return static_cast<size_t>(head.argument);
+    }
+
+    [[noreturn]] static void fail(const char* message, size_t offset) {
+        throw CborError(std::string(message) + " at offset " + std::to_string(offset));
+    }
+
+private:
+    std::string_view data_;
+    size_t pos_;
+
+    std::string_view take(size_t bytes) {
+        if (bytes > remaining()) {
+            fail("Unexpected end of input", data_.size());
+        }
+        std::string_view raw = data_.substr(pos_, bytes);
+        pos_ += bytes;
+        return raw;
+    }
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Encoding
+
+void writeCbor(const JsonValue& root, std::string& out) {
+    // 与 JsonWriter 一样用显式栈遍历
+    struct Cursor {
+        const JsonValue* container;
+        size_t next;
+    };
+    std::vector<Cursor> cursors;
+    const JsonValue* value = &root;
+    while (value) {
+        if (value->isObject()) {
+            putHead(out, kMap, value->asObject().size());
+            cursors.push_back(Cursor{value, 0});
+        } else if (value->isArray()) {
+            putHead(out, kArray, value->asArray().size());
+            cursors.push_back(Cursor{value, 0});
+        } else {
+            putScalar(out, *value);
+        }
+
+        value = nullptr;
+        while (!value && !cursors.empty()) {
+            Cursor& top = cursors.back();
+            if (top.container->isObject()) {
+                const JsonValue::Object& object = top.container->asObject();
+                if (top.next < object.size()) {
+                    const auto& member = object.begin()[top.next++];
+                    putText(out, member.first);
+                    value = &member.second;
+                } else {
+                    cursors.pop_back();
+                }
+            } else {
+                const JsonValue::Array& array = top.container->asArray();
+                if (top.next < array.size()) {
+                    value = &array[top.next++];
+                } else {
+                    cursors.pop_back();
+                }
+            }
+        }
+    }
+}
+
+std::string toCbor(const JsonValue& value) {
+    std::string out;
+    writeCbor(value, out);
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Decoding
+
+JsonValue parseCbor(std::string_view data, const ParseOptions& options) {
+    struct Frame {
+        bool isObject;
+        size_t remaining;
+        JsonValue::Array array;
+        JsonValue::Object object;
+        std::string key;
+    };
+
+    CborReader reader(data);
+    std::vector<Frame> stack;
+    JsonValue result;
+
+    auto readText = [&](const CborReader::Head& head) {
+        std::string_view text = reader.readPayload(head);
+        size_t errorOffset;
+        if (options.validateUtf8 && !validateUtf8(text, &errorOffset)) {
+            CborReader::fail("Invalid UTF-8", reader.position() - text.size() + errorOffset);
+        }
+        return text;
+    };
+
+    while (true) {
+        // 对象先读键
+        if (!stack.empty() && stack.back().isObject) {
+            CborReader::Head head = reader.readHead();
+            if (head.major != kText) {
+                CborReader::fail("Map key must be a text string", head.offset);
+            }
+            std::string_view key = readText(head);
+            stack.back().key.assign(key.data(), key.size());
+        }
+
+        CborReader::Head head = reader.readHead();
+        while (head.major == kTag) {
+            head = reader.readHead();
+        }
+
+        JsonValue value;
+        switch (head.major) {
+            case kUnsigned:
+                if (head.argument <= static_cast<uint64_t>(INT64_MAX)) {
+                    value = JsonValue(static_cast<int64_t>(head.argument));
+                } else {
+                    value = JsonValue(head.argument);
+                }
+                break;
+            case kNegative:
+                // -1 - n，超出 int64 范围时退化为 double
+                if (head.argument <= static_cast<uint64_t>(INT64_MAX)) {
+                    value = JsonValue(-1 - static_cast<int64_t>(head.argument));
+                } else {
+                    value = JsonValue(-1.0 - static_cast<double>(head.argument));
+                }
+                break;
+            case kBytes:
+                CborReader::fail("Byte strings are not supported", head.offset);
+            case kText: {
+                std::string_view text = readText(head);
+                value = JsonValue(std::string(text));
+                break;
+            }
+            case kArray:
+            case kMap: {
+                bool isObject = head.major == kMap;
+                size_t count = reader.readCount(head, isObject ? 2 : 1);
+                if (stack.size() >= options.maxDepth) {
+                    CborReader::fail("Maximum nesting depth exceeded", head.offset);
+                }
+                if (count > 0) {
+                    // 长度已知，预先分配
+                    stack.push_back(Frame{isObject, count, {}, {}, {}});
+                    if (isObject) {
+                        stack.back().object.reserve(count);
+                    } else {
+                        stack.back().array.reserve(count);
+                    }
+                    continue;
+                }
+                value = isObject ? JsonValue(JsonValue::Object()) : JsonValue(JsonValue::Array());
+                break;
+            }
+            default:
+                switch (head.info) {
+                    case kFalse:
+                        value = JsonValue(false);
+                        break;
+                    case kTrue:
+                        value = JsonValue(true);
+                        break;
+                    case kNull:
+                    case kUndefined:
+                        break;
+                    case kHalf:
+                        value = JsonValue(halfToDouble(static_cast<uint16_t>(head.argument)));
+                        break;
+                    case kFloat: {
+                        uint32_t bits = static_cast<uint32_t>(head.argument);
+                        float f;
+                        std::memcpy(&f, &bits, sizeof(f));
+                        value = JsonValue(static_cast<double>(f));
+                        break;
+                    }
+                    case kDouble: {
+                        double d;
+                        std::memcpy(&d, &head.argument, sizeof(d));
+                        value = JsonValue(d);
+                        break;
+                    }
+                    default:
+                        CborReader::fail("Unsupported simple value", head.offset);
+                }
+                break;
+        }
+
+        // 把完成的值放入外层容器；容器填满后继续向外回溯
+        while (true) {
+            if (stack.empty()) {
+                if (reader.remaining() != 0) {
+                    CborReader::fail("Unexpected data after item", reader.position());
+                }
+                return value;
+            }
+            Frame& top = stack.back();
+            if (top.isObject) {
+                top.object[std::move(top.key)] = std::move(value);
+            } else {
+                top.array.push_back(std::move(value));
+            }
+            if (--top.remaining > 0) {
+                break;
+            }
+            value = top.isObject ? JsonValue(std::move(top.object)) : JsonValue(std::move(top.array));
+            stack.pop_back();
+        }
+    }
+}
+
+size_t skipCbor(std::string_view data, size_t offset) {
+    // 只读取各项的头部，字符串按长度整体跳过
+    CborReader reader(data, offset);
+    uint64_t pending = 1;
+    while (pending > 0) {
+        CborReader::Head head = reader.readHead();
+        pending--;
+        switch (head.major) {
+            case kBytes:
+            case kText:
+                reader.readPayload(head);
+                break;
+            case kArray:
+                pending += reader.readCount(head, 1);
+                break;
+            case kMap:
+                pending += 2 * static_cast<uint64_t>(reader.readCount(head, 2));
+                break;
+            case kTag:
+                pending++;
+                break;
+            default:
+                break;
+        }
+        if (pending > reader.remaining()) {
+            CborReader::fail("Unexpected end of input", data.size());
+        }
+    }
+    return reader.position();
+}
+
+} // namespace json
@@ -0,0 +1,279 @@
+#include "json_document.h"
+#include "json_sax.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <variant>
+
+namespace json {
+
+// ---------------------------------------------------------------------------
+// Arena
+
+Arena::Arena(size_t blockSize)
+    : current_(0), blockSize_(blockSize), cursor_(nullptr), limit_(nullptr), used_(0), reserved_(0) {}
+
+Arena::Arena(Arena&& other) noexcept
+    : blocks_(std::move(other.blocks_)), current_(other.current_), blockSize_(other.blockSize_),
+      cursor_(other.cursor_), limit_(other.limit_), used_(other.used_), reserved_(other.reserved_) {
+    other.release();
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this != &other) {
+        blocks_ = std::move(other.blocks_);
+        current_ = other.current_;
+        blockSize_ = other.blockSize_;
+        cursor_ = other.cursor_;
+        limit_ = other.limit_;
+        used_ = other.used_;
+        reserved_ = other.reserved_;
+        // 源对象的游标仍指向已转移的块，必须清空
+        other.release();
+    }
+    return *this;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    uintptr_t p = reinterpret_cast<uintptr_t>(cursor_);
+    uintptr_t aligned = (p + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    if (!cursor_ || aligned + size > reinterpret_cast<uintptr_t>(limit_)) {
+        grow(size + alignment);
+        p = reinterpret_cast<uintptr_t>(cursor_);
+        aligned = (p + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    }
+    cursor_ = reinterpret_cast<char*>(aligned + size);
+    used_ += size;
+    return reinterpret_cast<void*>(aligned);
+}
+
+std::string_view Arena::copyString(std::string_view str) {
+    if (str.empty()) {
+        return std::string_view();
+    }
+    char* dst = static_cast<char*>(allocate(str.size(), 1));
+    std::memcpy(dst, str.data(), str.size());
+    return std::string_view(dst, str.size());
+}
+
+void Arena::reset() {
+    // 保留已分配的块，从第一个块重新开始
+    current_ = 0;
+    used_ = 0;
+    if (blocks_.empty()) {
+        cursor_ = nullptr;
+        limit_ = nullptr;
+    } else {
+        cursor_ = blocks_[0].data.get();
+        limit_ = cursor_ + blocks_[0].size;
+    }
+}
+
+void Arena::release() {
+    blocks_.clear();
+    current_ = 0;
+    cursor_ = nullptr;
+    limit_ = nullptr;
+    used_ = 0;
+    reserved_ = 0;
+}
+
+void Arena::grow(size_t minSize) {
+    // 优先复用 reset() 之前留下的下一个块
+    size_t next = cursor_ ? current_ + 1 : 0;
+    if (next < blocks_.size() && blocks_[next].size >= minSize) {
+        current_ = next;
+        cursor_ = blocks_[next].data.get();
+        limit_ = cursor_ + blocks_[next].size;
+        return;
+    }
+
+    // 块大小随文档增长翻倍，超大分配单独占用一个块
+    size_t size = blockSize_;
+    if (!blocks_.empty()) {
+        size = std::max(blockSize_, std::min<size_t>(reserved_, 16 * 1024 * 1024));
+    }
+    if (size < minSize) {
+        size = minSize;
+    }
+    blocks_.insert(blocks_.begin() + static_cast<std::ptrdiff_t>(next),
+                   Block{std::unique_ptr<char[]>(new char[size]), size});
+    current_ = next;
+    cursor_ = blocks_[next].data.get();
+    limit_ = cursor_ + size;
+    reserved_ += size;
+}
+
+// ---------------------------------------------------------------------------
+// DocValue
+
+DocValue DocValue::makeBoolean(bool b) {
+    DocValue v;
+    v.type_ = Type::Boolean;
+    v.payload_.boolean = b;
+    return v;
+}
+
+DocValue DocValue::makeNumber(double n) {
+    DocValue v;
+    v.type_ = Type::Number;
+    v.payload_.number = n;
+    return v;
+}
+
+DocValue DocValue::makeInteger(int64_t n) {
+    DocValue v;
+    v.type_ = Type::Integer;
+    v.payload_.integer = n;
+    return v;
+}
+
+DocValue DocValue::makeUnsigned(uint64_t n) {
+    DocValue v;
+    v.type_ = Type::Unsigned;
+    v.payload_.uinteger = n;
+    return v;
+}
+
+DocValue DocValue::makeString(std::string_view str) {
+    DocValue v;
+    v.type_ = Type::String;
+    v.size_ = static_cast<uint32_t>(str.size());
+    v.payload_.string = str.data();
+    return v;
+}
+
+DocValue DocValue::makeArray(const DocValue* elements, size_t count) {
+    DocValue v;
+    v.type_ = Type::Array;
+    v.size_ = static_cast<uint32_t>(count);
+    v.payload_.elements = elements;
+    return v;
+}
+
+DocValue DocValue::makeObject(const DocMember* members, size_t count) {
+    DocValue v;
+    v.type_ = Type::Object;
+    v.size_ = static_cast<uint32_t>(count);
+    v.payload_.members = members;
+    return v;
+}
+
+void DocValue::expect(Type type) const {
+    if (type_ != type) {
+        throw std::bad_variant_access();
+    }
+}
+
+DocObject DocValue::asObject() const {
+    expect(Type::Object);
+    return DocObject(payload_.members, size_);
+}
+
+DocArray DocValue::asArray() const {
+    expect(Type::Array);
+    return DocArray(payload_.elements, size_);
+}
+
+std::string_view DocValue::asString() const {
+    expect(Type::String);
+    return std::string_view(payload_.string, size_);
+}
+
+double DocValue::asNumber() const {
+    if (type_ == Type::Integer) {
+        return static_cast<double>(payload_.integer);
+    }
+    if (type_ == Type::Unsigned) {
+        return static_cast<double>(payload_.uinteger);
+    }
+    expect(Type::Number);
+    return payload_.number;
+}
+
+int64_t DocValue::asInt64() const {
+    if (type_ == Type::Unsigned) {
+        if (payload_.uinteger > static_cast<uint64_t>(INT64_MAX)) {
+            throw std::out_of_range("DocValue::asInt64");
+        }
+        return static_cast<int64_t>(payload_.uinteger);
+    }
+    expect(Type::Integer);
+    return payload_.integer;
+}
+
+uint64_t DocValue::asUint64() const {
+    if (type_ == Type::Integer) {
+        if (payload_.integer < 0) {
+            throw std::out_of_range("DocValue::asUint64");
+        }
+        return static_cast<uint64_t>(payload_.integer);
+    }
+    expect(Type::Unsigned);
+    return payload_.uinteger;
+}
+
+bool DocValue::asBoolean() const {
+    expect(Type::Boolean);
+    return payload_.boolean;
+}
+
+const DocValue& DocArray::at(size_t i) const {
+    if (i >= size_) {
+        throw std::out_of_range("DocArray::at");
+    }
+    return elements_[i];
+}
+
+const DocValue* DocObject::find(std::string_view key) const {
+    // 从后向前查找，重复的键与 JsonParser::parse 一样以最后一个为准
+    for (size_t i = size_; i-- > 0;) {
+        if (members_[i].key == key) {
+            return &members_[i].value;
+        }
+    }
+    return nullptr;
+}
+
+const DocValue* DocObject::find(InternedKey key) const {
+    // 未入表的空键指针为空，不能与空句柄相等
+    if (!key) {
+        return nullptr;
+    }
+    for (size_t i = size_; i-- > 0;) {
+        if (members_[i].key.data() == key.data()) {
+            return &members_[i].value;
+        }
+    }
+    return nullptr;
+}
+
+const DocValue& DocObject::at(std::string_view key) const {
+    const DocValue* value = find(key);
+    if (!value) {
+        throw std::out_of_range("DocObject::at");
+    }
+    return *value;
+}
+
+// ---------------------------------------------------------------------------
+// Document parsing
+
+
+Document Document::parse(std::string_view input, const ParseOptions& options) {
+    Document document;
+    DocumentBuilder builder(document.arena_, std::string_view(), options.keys);
+    parseSax(input, builder, options);
+    document.root_ = builder.root();
+    return document;
+}
+
+Document Document::parseBorrowed(std::string_view input, const ParseOptions& options) {
+    Document document;
+    DocumentBuilder builder(document.arena_, input, options.keys);
+    parseSax(input, builder, options);
+    document.root_ = builder.root();
+    return document;
+}
+
+} // namespace json
@@ -0,0 +1,126 @@
+#include "json_file.h"
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace json {
+
+namespace {
+
+std::string errorText(const std::string& what, const std::string& path) {
+    return what + " '" + path + "': " + std::strerror(errno);
+}
+
+} // namespace
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    // 没有mmap时整体读入内存
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw FileError(errorText("Cannot open", path));
+    }
+    std::string contents;
+    char buffer[1 << 16];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        contents.append(buffer, n);
+    }
+    bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+    if (failed) {
+        throw FileError(errorText("Cannot read", path));
+    }
+    if (!contents.empty()) {
+        char* copy = new char[contents.size()];
+        std::memcpy(copy, contents.data(), contents.size());
+        data_ = copy;
+        size_ = contents.size();
+    }
+}
+
+void MappedFile::release() {
+    delete[] data_;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw FileError(errorText("Cannot open", path));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        std::string message = errorText("Cannot stat", path);
+        ::close(fd);
+        throw FileError(message);
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        // 长度为0的映射不合法，空文件直接返回空视图
+        ::close(fd);
+        return;
+    }
+
+    void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    std::string message = address == MAP_FAILED ? errorText("Cannot map", path) : std::string();
+    // 映射建立后即可关闭描述符
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        throw FileError(message);
+    }
+    // 顺序读取提示：让内核提前预读
+    ::madvise(address, size, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const char*>(address);
+    size_ = size;
+    mapped_ = true;
+}
+
+void MappedFile::release() {
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mapped_(std::exchange(other.mapped_, false)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+    }
+    return *this;
+}
+
+JsonValue parseFile(const std::string& path, const ParseOptions& options) {
+    MappedFile file(path);
+    return JsonParser(file.view(), options).parse();
+}
+
+MappedDocument::MappedDocument(const std::string& path, const ParseOptions& options)
+    : file_(path), document_(Document::parseBorrowed(file_.view(), options)) {}
+
+} // namespace json
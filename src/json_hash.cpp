@@ -0,0 +1,199 @@
+#include "json_hash.h"
+#include "json_number.h"
+#include <cstring>
+
+namespace json {
+
+namespace {
+
+constexpr uint64_t kByteMultiplier = 0x9fb21c651e98df25ULL;
+
+// 按小端序读取，保证不同平台得到相同的哈希
+uint64_t loadWord(const char* p, size_t size) {
+    unsigned char bytes[8] = {};
+    std::memcpy(bytes, p, size);
+    uint64_t word = 0;
+    for (size_t i = 8; i-- > 0;) {
+        word = (word << 8) | bytes[i];
+    }
+    return word;
+}
+
+uint64_t hashNumber(const NumberValue& number) {
+    NumberValue canonical = canonicalNumber(number);
+    switch (canonical.kind) {
+        case NumberValue::Kind::Int64:
+            return detail::combineHash(detail::kNumberTag, static_cast<uint64_t>(canonical.i));
+        case NumberValue::Kind::UInt64:
+            // 规范形式中 UInt64 只剩大于 INT64_MAX 的值，位模式与负数相同，需要单独的标记
+            return detail::combineHash(detail::kUnsignedTag, canonical.u);
+        default: {
+            uint64_t bits;
+            std::memcpy(&bits, &canonical.d, sizeof(bits));
+            return detail::combineHash(detail::kDoubleTag, bits);
+        }
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+uint64_t hashBytes(std::string_view bytes) {
+    const char* p = bytes.data();
+    size_t size = bytes.size();
+    // 长度先混入，末尾不足 8 字节的部分补零也不会产生歧义
+    uint64_t h = mixHash(size * kByteMultiplier);
+    for (; size >= 8; p += 8, size -= 8) {
+        h = (h ^ mixHash(loadWord(p, 8))) * kByteMultiplier;
+    }
+    if (size > 0) {
+        h = (h ^ mixHash(loadWord(p, size))) * kByteMultiplier;
+    }
+    return mixHash(h);
+}
+
+uint64_t hashInteger(int64_t n) {
+    NumberValue number;
+    number.i = n;
+    return hashNumber(number);
+}
+
+uint64_t hashUnsigned(uint64_t n) {
+    NumberValue number;
+    number.kind = NumberValue::Kind::UInt64;
+    number.u = n;
+    return hashNumber(number);
+}
+
+uint64_t hashDouble(double n) {
+    NumberValue number;
+    number.kind = NumberValue::Kind::Double;
+    number.d = n;
+    return hashNumber(number);
+}
+
+} // namespace detail
+
+bool ContentHasher::onNull() { return emit(detail::hashNull()); }
+bool ContentHasher::onBoolean(bool b) { return emit(detail::hashBoolean(b)); }
+bool ContentHasher::onNumber(double n) { return emit(detail::hashDouble(n)); }
+bool ContentHasher::onInteger(int64_t n) { return emit(detail::hashInteger(n)); }
+bool ContentHasher::onUnsigned(uint64_t n) { return emit(detail::hashUnsigned(n)); }
+bool ContentHasher::onString(std::string_view s) { return emit(detail::hashString(s)); }
+
+bool ContentHasher::onKey(std::string_view key) {
+    stack_.back().key = detail::hashString(key);
+    return true;
+}
+
+bool ContentHasher::onStartObject() {
+    stack_.push_back(Frame{true, 0, 0});
+    return true;
+}
+
+bool ContentHasher::onEndObject(size_t memberCount) {
+    uint64_t hash = detail::objectHashFinish(stack_.back().state, memberCount);
+    stack_.pop_back();
+    return emit(hash);
+}
+
+bool ContentHasher::onStartArray() {
+    stack_.push_back(Frame{false, detail::arrayHashStart(), 0});
+    return true;
+}
+
+bool ContentHasher::onEndArray(size_t elementCount) {
+    uint64_t hash = detail::arrayHashFinish(stack_.back().state, elementCount);
+    stack_.pop_back();
+    return emit(hash);
+}
+
+void ContentHasher::reset() {
+    stack_.clear();
+    result_ = 0;
+}
+
+bool ContentHasher::emit(uint64_t hash) {
+    if (stack_.empty()) {
+        result_ = hash;
+    } else if (stack_.back().isObject) {
+        stack_.back().state = detail::objectHashAdd(stack_.back().state, stack_.back().key, hash);
+    } else {
+        stack_.back().state = detail::arrayHashAdd(stack_.back().state, hash);
+    }
+    return true;
+}
+
+uint64_t hashValue(const JsonValue& value) {
+    struct Cursor {
+        const JsonValue* container;
+        size_t next;
+    };
+
+    // 按文档顺序把树重放成事件，与 hashJson 共用同一个 ContentHasher，
+    // 两者的结果因此一致；显式栈避免深层嵌套时递归
+    ContentHasher hasher;
+    std::vector<Cursor> stack;
+    const JsonValue* current = &value;
+    for (;;) {
+        if (current) {
+            if (current->isArray()) {
+                hasher.onStartArray();
+                stack.push_back(Cursor{current, 0});
+            } else if (current->isObject()) {
+                hasher.onStartObject();
+                stack.push_back(Cursor{current, 0});
+            } else {
+                current->visit([&hasher](const auto& v) {
+                    using T = std::decay_t<decltype(v)>;
+                    if constexpr (std::is_same_v<T, JsonValue::String>) {
+                        hasher.onString(v);
+                    } else if constexpr (std::is_same_v<T, JsonValue::Number>) {
+                        hasher.onNumber(v);
+                    } else if constexpr (std::is_same_v<T, JsonValue::Integer>) {
+                        hasher.onInteger(v);
+                    } else if constexpr (std::is_same_v<T, JsonValue::Unsigned>) {
+                        hasher.onUnsigned(v);
+                    } else if constexpr (std::is_same_v<T, JsonValue::Boolean>) {
+                        hasher.onBoolean(v);
+                    } else if constexpr (std::is_same_v<T, JsonValue::Null>) {
+                        hasher.onNull();
+                    }
+                });
+            }
+            current = nullptr;
+        }
+        if (stack.empty()) {
+            break;
+        }
+        Cursor& top = stack.back();
+        if (top.container->isArray()) {
+            const JsonValue::Array& array = top.container->asArray();
+            if (top.next < array.size()) {
+                current = &array[top.next++];
+                continue;
+            }
+            hasher.onEndArray(array.size());
+        } else {
+            const JsonValue::Object& object = top.container->asObject();
+            if (top.next < object.size()) {
+                const auto& member = object.begin()[top.next++];
+                hasher.onKey(member.first);
+                current = &member.second;
+                continue;
+            }
+            hasher.onEndObject(object.size());
+        }
+        stack.pop_back();
+    }
+    return hasher.result();
+}
+
+uint64_t hashJson(std::string_view input, const ParseOptions& options) {
+    ContentHasher hasher;
+    parseSax(input, hasher, options);
+    return hasher.result();
+}
+
+} // namespace json
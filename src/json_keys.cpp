@@ -0,0 +1,150 @@
+#include "json_keys.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <mutex>
+
+namespace json {
+
+namespace {
+
+constexpr size_t kInitialSlots = 64;
+constexpr size_t kBlockSize = 16 * 1024;
+
+size_t hashKey(std::string_view key) {
+    return std::hash<std::string_view>{}(key);
+}
+
+} // namespace
+
+KeyTable::KeyTable(size_t maxKeys) : maxKeys_(maxKeys) {
+    slots_.resize(kInitialSlots, Slot{0, nullptr, 0});
+}
+
+InternedKey KeyTable::lookup(std::string_view key, size_t hash) const {
+    // 线性探测；负载不超过一半，空槽很快出现
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots_[i];
+        if (!slot.data) {
+            return InternedKey();
+        }
+        if (slot.hash == hash && slot.size == key.size() &&
+            std::memcmp(slot.data, key.data(), key.size()) == 0) {
+            return InternedKey(slot.data, slot.size);
+        }
+    }
+}
+
+InternedKey KeyTable::intern(std::string_view key) {
+    // 每次调用恰好计入命中、插入或拒绝之一，查找次数由三者相加得出
+    size_t hash = hashKey(key);
+
+    if (frozen_.load(std::memory_order_acquire)) {
+        // 冻结后只读，无需加锁
+        InternedKey found = lookup(key, hash);
+        (found ? hits_ : rejected_).fetch_add(1, std::memory_order_relaxed);
+        return found;
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        InternedKey found = lookup(key, hash);
+        if (found) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return found;
+        }
+    }
+
+    // 未命中时加写锁，再查一次以免其他线程刚插入
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    InternedKey found = lookup(key, hash);
+    if (found) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return found;
+    }
+    if (count_ >= maxKeys_ || frozen_.load(std::memory_order_relaxed) ||
+        key.size() > UINT32_MAX) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return InternedKey();
+    }
+    return insert(key, hash);
+}
+
+InternedKey KeyTable::find(std::string_view key) const {
+    if (frozen()) {
+        return lookup(key, hashKey(key));
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return lookup(key, hashKey(key));
+}
+
+InternedKey KeyTable::insert(std::string_view key, size_t hash) {
+    if ((count_ + 1) * 2 > slots_.size()) {
+        rehash(slots_.size() * 2);
+    }
+
+    // 键文本追加到块中，末尾补 0，空键也有唯一的非空地址
+    size_t bytes = key.size() + 1;
+    if (bytes > remaining_) {
+        size_t size = std::max(kBlockSize, bytes);
+        blocks_.push_back(std::unique_ptr<char[]>(new char[size]));
+        blockBytes_ += size;
+        cursor_ = blocks_.back().get();
+        remaining_ = size;
+    }
+    char* data = cursor_;
+    std::memcpy(data, key.data(), key.size());
+    data[key.size()] = '\0';
+    cursor_ += bytes;
+    remaining_ -= bytes;
+
+    size_t mask = slots_.size() - 1;
+    size_t i = hash & mask;
+    while (slots_[i].data) {
+        i = (i + 1) & mask;
+    }
+    slots_[i] = Slot{hash, data, static_cast<uint32_t>(key.size())};
+    count_++;
+    keyBytes_ += key.size();
+    return InternedKey(data, static_cast<uint32_t>(key.size()));
+}
+
+void KeyTable::rehash(size_t capacity) {
+    std::vector<Slot> slots(capacity, Slot{0, nullptr, 0});
+    size_t mask = capacity - 1;
+    for (const Slot& slot : slots_) {
+        if (slot.data) {
+            size_t i = slot.hash & mask;
+            while (slots[i].data) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+    slots_.swap(slots);
+}
+
+void KeyTable::freeze() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    frozen_.store(true, std::memory_order_release);
+}
+
+size_t KeyTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return count_;
+}
+
+KeyTableStats KeyTable::stats() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    KeyTableStats stats;
+    stats.keys = count_;
+    stats.keyBytes = keyBytes_;
+    stats.memoryBytes = blockBytes_ + slots_.capacity() * sizeof(Slot);
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.lookups = stats.hits + stats.rejected + count_;
+    return stats;
+}
+
+} // namespace json
@@ -1,20 +1,116 @@
 #include "json_lexer.h"
 #include <cctype>
-#include <sstream>
-#include <iomanip>
+#include <cstring>
 
 namespace json {
 
-JsonLexer::JsonLexer(const std::string& input)
-    : input_(input), current_(0), line_(1), column_(0) {}
+namespace {
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+unsigned int parseHex4(const char* p) {
+    unsigned int codePoint = 0;
+    for (int i = 0; i < 4; i++) {
+        codePoint = (codePoint << 4) | static_cast<unsigned int>(hexValue(p[i]));
+    }
+    return codePoint;
+}
+
+bool isJsonWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void appendUtf8(unsigned int codePoint, std::string& out) {
+    if (codePoint <= 0x7F) {
+        // ASCII字符
+        out += static_cast<char>(codePoint);
+    } else if (codePoint <= 0x7FF) {
+        // 2字节UTF-8
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint <= 0xFFFF) {
+        // 3字节UTF-8
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        // 4字节UTF-8
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+} // namespace
+
+JsonLexer::JsonLexer(std::string_view input, ScanMode mode, SimdLevel level)
+    : mode_(mode), level_(level) {
+    reset(input);
+}
+
+void JsonLexer::reset(std::string_view input) {
+    input_ = input;
+    current_ = 0;
+    start_ = 0;
+    nextStructural_ = 0;
+    indexed_ = mode_ == ScanMode::Indexed && input.size() <= StructuralIndex::kMaxInputSize;
+    if (indexed_) {
+        index_.build(input_, level_);
+    }
+}
 
 Token JsonLexer::nextToken() {
-    skipWhitespace();
+    if (indexed_) {
+        seekIndexed();
+    } else {
+        skipWhitespace();
+    }
     
+    start_ = current_;
     if (isAtEnd()) {
         return makeToken(TokenType::END_OF_FILE);
     }
     
+    return scanToken();
+}
+
+SourceLocation JsonLexer::locate(size_t offset) const {
+    if (offset > input_.size()) {
+        offset = input_.size();
+    }
+    size_t line = 1;
+    size_t lineStart = 0;
+    const char* data = input_.data();
+    while (lineStart < offset) {
+        const void* nl = std::memchr(data + lineStart, '\n', offset - lineStart);
+        if (!nl) {
+            break;
+        }
+        lineStart = static_cast<size_t>(static_cast<const char*>(nl) - data) + 1;
+        line++;
+    }
+    return SourceLocation{line, offset - lineStart + 1};
+}
+
+void JsonLexer::seekIndexed() {
+    // 跳过已被上一个词法单元消费的索引项
+    while (nextStructural_ < index_.size() && index_[nextStructural_] < current_) {
+        nextStructural_++;
+    }
+    if (isAtEnd() || !isJsonWhitespace(peek())) {
+        // 上一个标量后紧跟非空白字符：从当前位置继续，结果与顺序扫描一致
+        return;
+    }
+    current_ = nextStructural_ < index_.size() ? index_[nextStructural_] : input_.size();
+}
+
+Token JsonLexer::scanToken() {
     char c = advance();
     
     switch (c) {
@@ -24,28 +120,60 @@ Token JsonLexer::nextToken() {
         case ']': return makeToken(TokenType::RIGHT_BRACKET);
         case ',': return makeToken(TokenType::COMMA);
         case ':': return makeToken(TokenType::COLON);
-        case '"': return scanString();
+        case '"': return indexed_ ? scanIndexedString() : scanString();
         case 't': return scanIdentifier();
         case 'f': return scanIdentifier();
         case 'n': return scanIdentifier();
         default:
-            if (std::isdigit(c) || c == '-') {
+            if (std::isdigit(static_cast<unsigned char>(c)) || c == '-') {
                 current_--; // 回退一个字符，让scanNumber处理第一个字符
                 return scanNumber();
             }
-            return makeError("Unexpected character");
+            return makeError(LexErrorKind::UnexpectedCharacter, "Unexpected character");
     }
 }
 
-char JsonLexer::advance() {
-    char c = input_[current_++];
-    if (c == '\n') {
-        line_++;
-        column_ = 0;
-    } else {
-        column_++;
+void JsonLexer::unescape(std::string_view raw, std::string& out) {
+    size_t i = 0;
+    while (i < raw.size()) {
+        // 整段复制不含转义的部分
+        size_t next = raw.find('\\', i);
+        if (next == std::string_view::npos) {
+            out.append(raw.data() + i, raw.size() - i);
+            return;
+        }
+        out.append(raw.data() + i, next - i);
+        i = next + 1;
+
+        char c = raw[i++];
+        switch (c) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                unsigned int codePoint = parseHex4(raw.data() + i);
+                i += 4;
+                // 代理对：高代理后紧跟低代理时合并为一个码点
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF &&
+                    i + 6 <= raw.size() && raw[i] == '\\' && raw[i + 1] == 'u') {
+                    unsigned int low = parseHex4(raw.data() + i + 2);
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                }
+                appendUtf8(codePoint, out);
+                break;
+            }
+            default:
+                throw LexerError("Invalid escape sequence");
+        }
     }
-    return c;
 }
 
 char JsonLexer::peek() const {
@@ -60,7 +188,7 @@ bool JsonLexer::isAtEnd() const {
 void JsonLexer::skipWhitespace() {
     while (!isAtEnd()) {
         char c = peek();
-        if (std::isspace(c)) {
+        if (isJsonWhitespace(c)) {
             advance();
         } else {
             break;
@@ -68,153 +196,148 @@ void JsonLexer::skipWhitespace() {
     }
 }
 
-Token JsonLexer::makeToken(TokenType type, const std::string& value) {
-    return Token{type, value, line_, column_};
+Token JsonLexer::makeToken(TokenType type, std::string_view value) {
+    return Token{type, value, false, start_};
 }
 
-Token JsonLexer::makeError(const std::string& message) {
-    return Token{TokenType::ERROR, message, line_, column_};
+Token JsonLexer::makeError(LexErrorKind kind, const char* message) {
+    return Token{TokenType::ERROR, message, false, start_, kind};
+}
+
+Token JsonLexer::scanIndexedString() {
+    // 开引号之后的下一个索引项必然是闭引号
+    size_t closing = nextStructural_ + 1;
+    if (nextStructural_ >= index_.size() || index_[nextStructural_] != start_ ||
+        closing >= index_.size()) {
+        return scanString();
+    }
+    size_t end = index_[closing];
+    if (findStringSpecial(input_.data() + current_, end - current_) != end - current_) {
+        // 含转义或控制字符的字符串交给顺序扫描校验
+        return scanString();
+    }
+    Token token = makeToken(TokenType::STRING, input_.substr(current_, end - current_));
+    current_ = end + 1;
+    nextStructural_ = closing + 1;
+    return token;
 }
 
 Token JsonLexer::scanString() {
-    std::string value;
-    bool escaped = false;
+    // 只做校验，不解码：返回的值是输入中引号之间的原始片段
+    size_t start = current_;
+    bool hasEscapes = false;
     
-    while (!isAtEnd()) {
+    while (true) {
+        // 整段跳过普通字符，只在引号、反斜杠或控制字符处停下
+        current_ += findStringSpecial(input_.data() + current_, input_.size() - current_);
+        if (isAtEnd()) {
+            break;
+        }
         char c = peek();
-        if (c == '"' && !escaped) {
+        if (c == '"') {
+            Token token = makeToken(TokenType::STRING, input_.substr(start, current_ - start));
+            token.escaped = hasEscapes;
             advance(); // 消费结束的引号
-            return makeToken(TokenType::STRING, value);
+            return token;
         }
         
-        if (escaped) {
-            switch (c) {
-                case '"': value += '"'; break;
-                case '\\': value += '\\'; break;
-                case '/': value += '/'; break;
-                case 'b': value += '\b'; break;
-                case 'f': value += '\f'; break;
-                case 'n': value += '\n'; break;
-                case 'r': value += '\r'; break;
-                case 't': value += '\t'; break;
-                case 'u': {
-                    // 处理Unicode转义序列
-                    std::string hex;
+        if (c == '\\') {
+            hasEscapes = true;
+            advance();
+            if (isAtEnd()) {
+                break;
+            }
+            switch (peek()) {
+                case '"': case '\\': case '/':
+                case 'b': case 'f': case 'n': case 'r': case 't':
+                    break;
+                case 'u':
+                    // 校验四位十六进制数字
                     for (int i = 0; i < 4; i++) {
                         advance();
                         if (isAtEnd()) {
-                            return makeError("Incomplete Unicode escape sequence");
+                            return makeError(LexErrorKind::InvalidEscape, "Incomplete Unicode escape sequence");
                         }
-                        hex += peek();
-                    }
-                    
-                    // 将十六进制字符串转换为Unicode字符
-                    try {
-                        unsigned int codePoint = std::stoi(hex, nullptr, 16);
-                        if (codePoint <= 0x7F) {
-                            // ASCII字符
-                            value += static_cast<char>(codePoint);
-                        } else if (codePoint <= 0x7FF) {
-                            // 2字节UTF-8
-                            value += static_cast<char>(0xC0 | (codePoint >> 6));
-                            value += static_cast<char>(0x80 | (codePoint & 0x3F));
-                        } else if (codePoint <= 0xFFFF) {
-                            // 3字节UTF-8
-                            value += static_cast<char>(0xE0 | (codePoint >> 12));
-                            value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
-                            value += static_cast<char>(0x80 | (codePoint & 0x3F));
-                        } else {
-                            // 4字节UTF-8
-                            value += static_cast<char>(0xF0 | (codePoint >> 18));
-                            value += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
-                            value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
-                            value += static_cast<char>(0x80 | (codePoint & 0x3F));
+                        if (hexValue(peek()) < 0) {
+                            return makeError(LexErrorKind::InvalidEscape, "Invalid Unicode escape sequence");
                         }
-                    } catch (const std::exception&) {
-                        return makeError("Invalid Unicode escape sequence");
                     }
                     break;
-                }
                 default:
-                    return makeError("Invalid escape sequence");
+                    return makeError(LexErrorKind::InvalidEscape, "Invalid escape sequence");
             }
-            escaped = false;
-        } else if (c == '\\') {
-            escaped = true;
         } else {
-            value += c;
+            return makeError(LexErrorKind::ControlCharacter, "Invalid control character in string");
         }
         advance();
     }
     
-    return makeError("Unterminated string");
+    return makeError(LexErrorKind::UnterminatedString, "Unterminated string");
 }
 
 Token JsonLexer::scanNumber() {
-    std::string value;
-    bool hasDecimal = false;
+    size_t start = current_;
     
     // 处理负号
     if (peek() == '-') {
-        value += advance();
+        advance();
     }
     
     // 处理整数部分
-    if (!std::isdigit(peek())) {
-        return makeError("Expected digit");
+    if (!std::isdigit(static_cast<unsigned char>(peek()))) {
+        return makeError(LexErrorKind::InvalidNumber, "Expected digit");
     }
     
-    while (!isAtEnd() && std::isdigit(peek())) {
-        value += advance();
+    while (!isAtEnd() && std::isdigit(static_cast<unsigned char>(peek()))) {
+        advance();
     }
     
     // 处理小数部分
     if (!isAtEnd() && peek() == '.') {
-        hasDecimal = true;
-        value += advance();
+        advance();
         
-        if (!std::isdigit(peek())) {
-            return makeError("Expected digit after decimal point");
+        if (!std::isdigit(static_cast<unsigned char>(peek()))) {
+            return makeError(LexErrorKind::InvalidNumber, "Expected digit after decimal point");
         }
         
-        while (!isAtEnd() && std::isdigit(peek())) {
-            value += advance();
+        while (!isAtEnd() && std::isdigit(static_cast<unsigned char>(peek()))) {
+            advance();
         }
     }
     
     // 处理指数部分
     if (!isAtEnd() && (peek() == 'e' || peek() == 'E')) {
-        value += advance();
+        advance();
         
         if (!isAtEnd() && (peek() == '+' || peek() == '-')) {
-            value += advance();
+            advance();
         }
         
-        if (!std::isdigit(peek())) {
-            return makeError("Expected digit in exponent");
+        if (!std::isdigit(static_cast<unsigned char>(peek()))) {
+            return makeError(LexErrorKind::InvalidNumber, "Expected digit in exponent");
         }
         
-        while (!isAtEnd() && std::isdigit(peek())) {
-            value += advance();
+        while (!isAtEnd() && std::isdigit(static_cast<unsigned char>(peek()))) {
+            advance();
         }
     }
     
-    return makeToken(TokenType::NUMBER, value);
+    return makeToken(TokenType::NUMBER, input_.substr(start, current_ - start));
 }
 
 Token JsonLexer::scanIdentifier() {
-    std::string value;
-    value += input_[current_ - 1]; // 添加第一个字符
+    size_t start = current_ - 1; // 包含第一个字符
     
-    while (!isAtEnd() && std::isalpha(peek())) {
-        value += advance();
+    while (!isAtEnd() && std::isalpha(static_cast<unsigned char>(peek()))) {
+        advance();
     }
     
+    std::string_view value = input_.substr(start, current_ - start);
     if (value == "true") return makeToken(TokenType::TRUE);
     if (value == "false") return makeToken(TokenType::FALSE);
     if (value == "null") return makeToken(TokenType::NULL_);
     
-    return makeError("Invalid identifier");
+    return makeError(LexErrorKind::InvalidLiteral, "Invalid identifier");
 }
 
-} // namespace json 
\ No newline at end of file
+} // namespace json
@@ -0,0 +1,141 @@
+#include "json_ndjson.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <thread>
+
+namespace json {
+
+namespace {
+
+bool isBlank(std::string_view line) {
+    return line.find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+} // namespace
+
+NdjsonReader::NdjsonReader(const NdjsonOptions& options) : options_(options) {
+    size_t threads = options_.threads;
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    // 调用方线程也参与解析，所以只需 threads - 1 个工作线程
+    if (threads > 1) {
+        ownedPool_ = std::make_unique<ThreadPool>(threads - 1);
+        pool_ = ownedPool_.get();
+    }
+}
+
+NdjsonReader::NdjsonReader(ThreadPool& pool, const NdjsonOptions& options)
+    : options_(options), pool_(&pool) {}
+
+void NdjsonReader::run(size_t count, const std::function<void(size_t)>& body) {
+    if (pool_) {
+        pool_->parallelFor(count, body);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        body(i);
+    }
+}
+
+std::vector<NdjsonReader::Batch> NdjsonReader::split(std::string_view input) {
+    // 按大致大小切分，每个批次在换行符之后结束
+    std::vector<Batch> batches;
+    size_t batchBytes = std::max<size_t>(1, options_.batchBytes);
+    size_t begin = 0;
+    while (begin < input.size()) {
+        size_t end = input.size();
+        if (input.size() - begin > batchBytes) {
+            const void* newline = std::memchr(input.data() + begin + batchBytes, '\n',
+                                              input.size() - begin - batchBytes);
+            if (newline) {
+                end = static_cast<const char*>(newline) - input.data() + 1;
+            }
+        }
+        batches.push_back({begin, end, 0});
+        begin = end;
+    }
+
+    // 并行统计每个批次的行数，再求前缀和得到起始行号
+    std::vector<size_t> lineCounts(batches.size());
+    run(batches.size(), [&](size_t i) {
+        const char* data = input.data() + batches[i].begin;
+        lineCounts[i] = std::count(data, data + (batches[i].end - batches[i].begin), '\n');
+    });
+    size_t line = 1;
+    for (size_t i = 0; i < batches.size(); ++i) {
+        batches[i].firstLine = line;
+        line += lineCounts[i];
+    }
+    return batches;
+}
+
+void NdjsonReader::parseBatch(std::string_view input, const Batch& batch,
+                              const Callback& emit, ParseStats& stats) const {
+    // 同一批次内复用解析器的缓冲区
+    JsonParser parser(options_.parse);
+    size_t line = batch.firstLine;
+    size_t pos = batch.begin;
+    while (pos < batch.end) {
+        size_t newline = input.find('\n', pos);
+        size_t end = newline == std::string_view::npos || newline > batch.end ? batch.end : newline;
+        std::string_view text = input.substr(pos, end - pos);
+        if (!isBlank(text)) {
+            NdjsonRecord record;
+            record.line = line;
+            try {
+                record.value = parser.parse(text);
+            } catch (const ParserError& e) {
+                record.error = e.what();
+            }
+            if constexpr (kStatsEnabled) {
+                stats += parser.stats();
+            }
+            emit(std::move(record));
+        }
+        pos = end + 1;
+        line++;
+    }
+}
+
+void NdjsonReader::collectStats(const std::vector<ParseStats>& batchStats) {
+    // 每个批次各自累计，结束后再合并，线程之间不共享计数器
+    stats_ = ParseStats();
+    for (const ParseStats& stats : batchStats) {
+        stats_ += stats;
+    }
+}
+
+std::vector<NdjsonRecord> NdjsonReader::parse(std::string_view input) {
+    std::vector<Batch> batches = split(input);
+    std::vector<std::vector<NdjsonRecord>> results(batches.size());
+    std::vector<ParseStats> batchStats(batches.size());
+    run(batches.size(), [&](size_t i) {
+        parseBatch(input, batches[i], [&results, i](NdjsonRecord&& record) {
+            results[i].push_back(std::move(record));
+        }, batchStats[i]);
+    });
+    collectStats(batchStats);
+
+    // 按批次顺序拼接
+    size_t total = 0;
+    for (const auto& batch : results) {
+        total += batch.size();
+    }
+    std::vector<NdjsonRecord> records;
+    records.reserve(total);
+    for (auto& batch : results) {
+        std::move(batch.begin(), batch.end(), std::back_inserter(records));
+    }
+    return records;
+}
+
+void NdjsonReader::parseUnordered(std::string_view input, const Callback& callback) {
+    std::vector<Batch> batches = split(input);
+    std::vector<ParseStats> batchStats(batches.size());
+    run(batches.size(), [&](size_t i) { parseBatch(input, batches[i], callback, batchStats[i]); });
+    collectStats(batchStats);
+}
+
+} // namespace json
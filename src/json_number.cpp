@@ -0,0 +1,181 @@
+#include "json_number.h"
+#include "json_parser.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace json {
+
+namespace {
+
+// Powers of ten that are exactly representable as doubles
+const double kExactPowers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool slowPath(std::string_view text, double& value) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+} // namespace
+
+NumberValue parseNumber(std::string_view text) {
+    NumberValue number;
+    if (!tryParseNumber(text, number)) {
+        throw ParserError("Number out of range");
+    }
+    return number;
+}
+
+bool tryParseNumber(std::string_view text, NumberValue& number) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    bool negative = false;
+    if (p != end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+
+    // 整数部分：最多19位十进制数字不会溢出uint64
+    uint64_t mantissa = 0;
+    int digits = 0;
+    const char* integerStart = p;
+    while (p != end && *p >= '0' && *p <= '9') {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    digits = static_cast<int>(p - integerStart);
+
+    if (p == end) {
+        if (digits <= 19) {
+            if (!negative) {
+                if (mantissa <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                    number.kind = NumberValue::Kind::Int64;
+                    number.i = static_cast<int64_t>(mantissa);
+                } else {
+                    number.kind = NumberValue::Kind::UInt64;
+                    number.u = mantissa;
+                }
+                return true;
+            }
+            // -0 保留为浮点数以保留符号
+            if (mantissa != 0 && mantissa <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1) {
+                number.kind = NumberValue::Kind::Int64;
+                number.i = static_cast<int64_t>(0 - mantissa);
+                return true;
+            }
+        } else if (digits == 20 && !negative) {
+            // 20位数字可能仍在uint64范围内
+            uint64_t value = 0;
+            auto result = std::from_chars(integerStart, end, value);
+            if (result.ec == std::errc() && result.ptr == end) {
+                number.kind = NumberValue::Kind::UInt64;
+                number.u = value;
+                return true;
+            }
+        }
+    }
+
+    number.kind = NumberValue::Kind::Double;
+
+    // 小数部分
+    int exponent = 0;
+    if (p != end && *p == '.') {
+        ++p;
+        const char* fractionStart = p;
+        while (p != end && *p >= '0' && *p <= '9') {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            ++p;
+        }
+        exponent = -static_cast<int>(p - fractionStart);
+        digits += static_cast<int>(p - fractionStart);
+    }
+
+    // 指数部分
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p != end && (*p == '+' || *p == '-')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        int explicitExponent = 0;
+        while (p != end && *p >= '0' && *p <= '9') {
+            if (explicitExponent < 100000) {
+                explicitExponent = explicitExponent * 10 + (*p - '0');
+            }
+            ++p;
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    // Clinger快速路径：尾数和10的幂都能精确表示为double时，一次乘除即为正确舍入
+    if (digits <= 19 && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        double value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / kExactPowers[-exponent] : value * kExactPowers[exponent];
+        number.d = negative ? -value : value;
+        return true;
+    }
+
+    return slowPath(text, number.d);
+}
+
+NumberValue canonicalNumber(NumberValue number) {
+    if (number.kind == NumberValue::Kind::UInt64) {
+        if (number.u <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            number.kind = NumberValue::Kind::Int64;
+        }
+    } else if (number.kind == NumberValue::Kind::Double) {
+        // 2^63 与 2^64 可精确表示为 double，区间左闭右开
+        double d = number.d;
+        if (d >= -9223372036854775808.0 && d < 9223372036854775808.0 && std::trunc(d) == d) {
+            number.kind = NumberValue::Kind::Int64;
+            number.i = static_cast<int64_t>(d);
+        } else if (d >= 9223372036854775808.0 && d < 18446744073709551616.0 && std::trunc(d) == d) {
+            number.kind = NumberValue::Kind::UInt64;
+            number.u = static_cast<uint64_t>(d);
+        }
+    }
+    return number;
+}
+
+bool sameNumber(const NumberValue& a, const NumberValue& b) {
+    NumberValue x = canonicalNumber(a);
+    NumberValue y = canonicalNumber(b);
+    if (x.kind != y.kind) {
+        return false;
+    }
+    switch (x.kind) {
+        case NumberValue::Kind::Int64: return x.i == y.i;
+        case NumberValue::Kind::UInt64: return x.u == y.u;
+        default: return x.d == y.d;
+    }
+}
+
+size_t formatNumber(double value, char* buffer) {
+    if (!std::isfinite(value)) {
+        std::memcpy(buffer, "null", 4);
+        return 4;
+    }
+    // to_chars 不带精度参数时输出最短的可往返表示
+    auto result = std::to_chars(buffer, buffer + kMaxNumberLength, value);
+    return static_cast<size_t>(result.ptr - buffer);
+}
+
+size_t formatNumber(int64_t value, char* buffer) {
+    auto result = std::to_chars(buffer, buffer + kMaxNumberLength, value);
+    return static_cast<size_t>(result.ptr - buffer);
+}
+
+size_t formatNumber(uint64_t value, char* buffer) {
+    auto result = std::to_chars(buffer, buffer + kMaxNumberLength, value);
+    return static_cast<size_t>(result.ptr - buffer);
+}
+
+} // namespace json
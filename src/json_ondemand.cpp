@@ -0,0 +1,345 @@
+#include "json_ondemand.h"
+#include "json_parser.h"
+#include <cstring>
+#include <sstream>
+#include <variant>
+
+namespace json {
+
+namespace {
+
+// A scalar must be followed by whitespace, a structural character or the end
+bool isDelimiter(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+           c == ',' || c == ']' || c == '}' || c == ':';
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// LazyDocument
+
+LazyDocument::LazyDocument(std::string_view input, SimdLevel level)
+    : input_(input) {
+    if (input.size() > StructuralIndex::kMaxInputSize) {
+        throw ParserError("Input too large for on-demand parsing");
+    }
+    index_.build(input_, level);
+    if (index_.unclosedString()) {
+        fail("Unterminated string", index_.size() - 1);
+    }
+}
+
+char LazyDocument::charAt(size_t entry) const {
+    return entry < index_.size() ? input_[index_[entry]] : '\0';
+}
+
+size_t LazyDocument::offsetOf(size_t entry) const {
+    return entry < index_.size() ? index_[entry] : input_.size();
+}
+
+size_t LazyDocument::skip(size_t entry) const {
+    char c = charAt(entry);
+    if (c == '"') {
+        return entry + 2;
+    }
+    if (c != '{' && c != '[') {
+        return entry + 1;
+    }
+    // 括号匹配：字符串内容不在索引中，只需计数括号
+    size_t depth = 0;
+    for (size_t i = entry; i < index_.size(); ++i) {
+        char d = input_[index_[i]];
+        if (d == '{' || d == '[') {
+            depth++;
+        } else if (d == '}' || d == ']') {
+            if (--depth == 0) {
+                return i + 1;
+            }
+        }
+    }
+    fail(c == '{' ? "Expected '}' after object" : "Expected ']' after array", index_.size());
+}
+
+size_t LazyDocument::nextMember(size_t valueEntry, char close) const {
+    size_t next = skip(valueEntry);
+    char c = charAt(next);
+    if (c == ',') {
+        return next + 1;
+    }
+    if (c == close) {
+        return npos;
+    }
+    fail(close == '}' ? "Expected '}' after object" : "Expected ']' after array", next);
+}
+
+bool LazyDocument::keyEquals(size_t entry, std::string_view key) const {
+    size_t begin = index_[entry] + 1;
+    std::string_view raw = input_.substr(begin, index_[entry + 1] - begin);
+    if (std::memchr(raw.data(), '\\', raw.size()) == nullptr) {
+        return raw == key;
+    }
+    return decodeKey(entry) == key;
+}
+
+std::string LazyDocument::decodeKey(size_t entry) const {
+    JsonLexer lexer(input_.substr(index_[entry]));
+    Token token = lexer.nextToken();
+    if (token.type != TokenType::STRING) {
+        fail(std::string(token.value), entry);
+    }
+    std::string decoded;
+    if (token.escaped) {
+        JsonLexer::unescape(token.value, decoded);
+    } else {
+        decoded.assign(token.value.data(), token.value.size());
+    }
+    return decoded;
+}
+
+void LazyDocument::fail(const std::string& message, size_t entry) const {
+    JsonLexer lexer(input_);
+    SourceLocation location = lexer.locate(offsetOf(entry));
+    std::stringstream ss;
+    ss << message << " at line " << location.line << ", column " << location.column;
+    throw ParserError(ss.str());
+}
+
+// ---------------------------------------------------------------------------
+// LazyValue
+
+char LazyValue::first() const {
+    return doc_->charAt(entry_);
+}
+
+bool LazyValue::isNumber() const {
+    char c = first();
+    return c == '-' || (c >= '0' && c <= '9');
+}
+
+LazyObject LazyValue::asObject() const {
+    if (!isObject()) {
+        throw std::bad_variant_access();
+    }
+    return LazyObject(doc_, entry_);
+}
+
+LazyArray LazyValue::asArray() const {
+    if (!isArray()) {
+        throw std::bad_variant_access();
+    }
+    return LazyArray(doc_, entry_);
+}
+
+std::string LazyValue::asString() const {
+    if (!isString()) {
+        throw std::bad_variant_access();
+    }
+    return doc_->decodeKey(entry_);
+}
+
+NumberValue LazyValue::number() const {
+    if (!isNumber()) {
+        throw std::bad_variant_access();
+    }
+    size_t offset = doc_->offsetOf(entry_);
+    JsonLexer lexer(doc_->input_.substr(offset));
+    Token token = lexer.nextToken();
+    if (token.type != TokenType::NUMBER) {
+        doc_->fail(std::string(token.value), entry_);
+    }
+    size_t end = offset + lexer.position();
+    if (end < doc_->input_.size() && !isDelimiter(doc_->input_[end])) {
+        doc_->fail("Unexpected character", entry_);
+    }
+    return parseNumber(token.value);
+}
+
+bool LazyValue::isInt() const {
+    return isNumber() && number().kind != NumberValue::Kind::Double;
+}
+
+double LazyValue::asNumber() const {
+    NumberValue n = number();
+    switch (n.kind) {
+        case NumberValue::Kind::Int64: return static_cast<double>(n.i);
+        case NumberValue::Kind::UInt64: return static_cast<double>(n.u);
+        default: return n.d;
+    }
+}
+
+int64_t LazyValue::asInt64() const {
+    NumberValue n = number();
+    if (n.kind == NumberValue::Kind::Double) {
+        throw std::bad_variant_access();
+    }
+    if (n.kind == NumberValue::Kind::UInt64 && n.u > static_cast<uint64_t>(INT64_MAX)) {
+        throw std::out_of_range("LazyValue::asInt64");
+    }
+    return n.i;
+}
+
+uint64_t LazyValue::asUint64() const {
+    NumberValue n = number();
+    if (n.kind == NumberValue::Kind::Double) {
+        throw std::bad_variant_access();
+    }
+    if (n.kind == NumberValue::Kind::Int64 && n.i < 0) {
+        throw std::out_of_range("LazyValue::asUint64");
+    }
+    return n.u;
+}
+
+bool LazyValue::asBoolean() const {
+    if (!isBoolean()) {
+        throw std::bad_variant_access();
+    }
+    size_t offset = doc_->offsetOf(entry_);
+    JsonLexer lexer(doc_->input_.substr(offset));
+    Token token = lexer.nextToken();
+    if (token.type == TokenType::ERROR) {
+        doc_->fail(std::string(token.value), entry_);
+    }
+    size_t end = offset + lexer.position();
+    if (end < doc_->input_.size() && !isDelimiter(doc_->input_[end])) {
+        doc_->fail("Invalid identifier", entry_);
+    }
+    return token.type == TokenType::TRUE;
+}
+
+LazyValue LazyValue::operator[](std::string_view key) const {
+    return asObject().at(key);
+}
+
+LazyValue LazyValue::operator[](size_t index) const {
+    return asArray().at(index);
+}
+
+std::string_view LazyValue::raw() const {
+    size_t begin = doc_->offsetOf(entry_);
+    char c = first();
+    size_t end;
+    if (c == '{' || c == '[') {
+        end = doc_->offsetOf(doc_->skip(entry_) - 1) + 1;
+    } else if (c == '"') {
+        end = doc_->offsetOf(entry_ + 1) + 1;
+    } else {
+        JsonLexer lexer(doc_->input_.substr(begin));
+        lexer.nextToken();
+        end = begin + lexer.position();
+    }
+    return doc_->input_.substr(begin, end - begin);
+}
+
+JsonValue LazyValue::materialize() const {
+    JsonParser parser(raw());
+    return parser.parse();
+}
+
+// ---------------------------------------------------------------------------
+// LazyObject
+
+size_t LazyObject::firstMember() const {
+    size_t i = entry_ + 1;
+    return doc_->charAt(i) == '}' ? LazyDocument::npos : i;
+}
+
+bool LazyObject::findMember(std::string_view key, size_t& valueEntry) const {
+    for (size_t i = firstMember(); i != LazyDocument::npos; i = doc_->nextMember(i + 3, '}')) {
+        if (doc_->charAt(i) != '"') {
+            doc_->fail("Expected string key", i);
+        }
+        if (doc_->charAt(i + 2) != ':') {
+            doc_->fail("Expected ':' after key", i + 2);
+        }
+        if (doc_->keyEquals(i, key)) {
+            valueEntry = i + 3;
+            return true;
+        }
+    }
+    return false;
+}
+
+LazyObject::iterator LazyObject::begin() const {
+    return iterator(doc_, firstMember());
+}
+
+LazyObject::iterator LazyObject::end() const {
+    return iterator(doc_, LazyDocument::npos);
+}
+
+size_t LazyObject::size() const {
+    size_t n = 0;
+    for (auto it = begin(); it != end(); ++it) {
+        n++;
+    }
+    return n;
+}
+
+LazyValue LazyObject::at(std::string_view key) const {
+    size_t valueEntry = 0;
+    if (!findMember(key, valueEntry)) {
+        throw std::out_of_range("LazyObject::at");
+    }
+    return LazyValue(doc_, valueEntry);
+}
+
+size_t LazyObject::count(std::string_view key) const {
+    size_t valueEntry = 0;
+    return findMember(key, valueEntry) ? 1 : 0;
+}
+
+std::pair<std::string, LazyValue> LazyObject::iterator::operator*() const {
+    if (doc_->charAt(entry_) != '"') {
+        doc_->fail("Expected string key", entry_);
+    }
+    if (doc_->charAt(entry_ + 2) != ':') {
+        doc_->fail("Expected ':' after key", entry_ + 2);
+    }
+    return {doc_->decodeKey(entry_), LazyValue(doc_, entry_ + 3)};
+}
+
+LazyObject::iterator& LazyObject::iterator::operator++() {
+    if (doc_->charAt(entry_ + 2) != ':') {
+        doc_->fail("Expected ':' after key", entry_ + 2);
+    }
+    entry_ = doc_->nextMember(entry_ + 3, '}');
+    return *this;
+}
+
+// ---------------------------------------------------------------------------
+// LazyArray
+
+LazyArray::iterator LazyArray::begin() const {
+    size_t i = entry_ + 1;
+    return iterator(doc_, doc_->charAt(i) == ']' ? LazyDocument::npos : i);
+}
+
+LazyArray::iterator LazyArray::end() const {
+    return iterator(doc_, LazyDocument::npos);
+}
+
+size_t LazyArray::size() const {
+    size_t n = 0;
+    for (auto it = begin(); it != end(); ++it) {
+        n++;
+    }
+    return n;
+}
+
+LazyValue LazyArray::at(size_t index) const {
+    size_t i = 0;
+    for (auto it = begin(); it != end(); ++it, ++i) {
+        if (i == index) {
+            return *it;
+        }
+    }
+    throw std::out_of_range("LazyArray::at");
+}
+
+LazyArray::iterator& LazyArray::iterator::operator++() {
+    entry_ = doc_->nextMember(entry_, ']');
+    return *this;
+}
+
+} // namespace json
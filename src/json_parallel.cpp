@@ -0,0 +1,260 @@
+#include "json_parallel.h"
+#include "json_sax.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace json {
+
+namespace {
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// 紧邻 pos 之前的反斜杠个数为奇数时，pos 处的字符是转义字符
+bool escapedAt(std::string_view input, size_t pos, size_t floor) {
+    size_t run = 0;
+    while (pos > floor && input[pos - 1] == '\\') {
+        --pos;
+        ++run;
+    }
+    return run % 2 == 1;
+}
+
+// [begin, end) 中未转义的引号数
+size_t countQuotes(std::string_view input, size_t begin, size_t end, size_t floor) {
+    size_t count = 0;
+    const char* data = input.data();
+    for (size_t pos = begin; pos < end;) {
+        const void* quote = std::memchr(data + pos, '"', end - pos);
+        if (!quote) {
+            break;
+        }
+        size_t at = static_cast<const char*>(quote) - data;
+        count += !escapedAt(input, at, floor);
+        pos = at + 1;
+    }
+    return count;
+}
+
+struct ScanResult {
+    long depth;    // Bracket depth at `end`
+    size_t comma;  // First comma at depth 1, or npos
+};
+
+// 从已知的字符串状态和深度出发扫描 [begin, end)；findComma 时遇到深度 1 的逗号即停
+ScanResult scan(std::string_view input, size_t begin, size_t end, size_t floor,
+                bool inString, long depth, bool findComma) {
+    const char* data = input.data();
+    size_t pos = begin;
+    if (inString && escapedAt(input, pos, floor)) {
+        pos++;
+    }
+    while (pos < end) {
+        if (inString) {
+            // 字符串内部整块跳到下一个引号或反斜杠
+            pos += findStringSpecial(data + pos, end - pos);
+            if (pos >= end) {
+                break;
+            }
+            if (data[pos] == '"') {
+                inString = false;
+            } else if (data[pos] == '\\') {
+                pos++;
+            }
+            pos++;
+            continue;
+        }
+        switch (data[pos]) {
+            case '"':
+                inString = true;
+                break;
+            case '[':
+            case '{':
+                depth++;
+                break;
+            case ']':
+            case '}':
+                depth--;
+                break;
+            case ',':
+                if (findComma && depth == 1) {
+                    return ScanResult{depth, pos};
+                }
+                break;
+            default:
+                break;
+        }
+        pos++;
+    }
+    return ScanResult{depth, std::string_view::npos};
+}
+
+} // namespace
+
+ParallelParser::ParallelParser(const ParallelOptions& options) : options_(options) {
+    size_t threads = options_.threads;
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    // 调用方线程也参与解析，所以只需 threads - 1 个工作线程
+    if (threads > 1) {
+        ownedPool_ = std::make_unique<ThreadPool>(threads - 1);
+        pool_ = ownedPool_.get();
+    }
+}
+
+ParallelParser::ParallelParser(ThreadPool& pool, const ParallelOptions& options)
+    : options_(options), pool_(&pool) {}
+
+void ParallelParser::run(size_t count, const std::function<void(size_t)>& body) {
+    if (pool_) {
+        pool_->parallelFor(count, body);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        body(i);
+    }
+}
+
+std::vector<ParallelParser::Piece> ParallelParser::split(std::string_view input, size_t open,
+                                                         size_t close) {
+    size_t begin = open + 1;
+    size_t chunkBytes = std::max<size_t>(1, options_.chunkBytes);
+    size_t chunks = (close - begin) / chunkBytes;
+    if (chunks < 2) {
+        return {Piece{begin, close}};
+    }
+    auto chunkBegin = [&](size_t i) { return begin + i * chunkBytes; };
+    auto chunkEnd = [&](size_t i) { return i + 1 == chunks ? close : chunkBegin(i + 1); };
+
+    // 第一遍：每块的引号数，前缀奇偶性给出每块开头是否在字符串内
+    std::vector<size_t> quotes(chunks);
+    run(chunks, [&](size_t i) { quotes[i] = countQuotes(input, chunkBegin(i), chunkEnd(i), begin); });
+    std::vector<char> inString(chunks);
+    size_t parity = 0;
+    for (size_t i = 0; i < chunks; ++i) {
+        inString[i] = parity % 2 == 1;
+        parity += quotes[i];
+    }
+
+    // 第二遍：每块的深度变化，前缀和给出每块开头的深度
+    std::vector<long> depth(chunks);
+    run(chunks, [&](size_t i) {
+        depth[i] = scan(input, chunkBegin(i), chunkEnd(i), begin, inString[i], 0, false).depth;
+    });
+    long level = 1;
+    for (size_t i = 0; i < chunks; ++i) {
+        std::swap(level, depth[i]);
+        level += depth[i];
+    }
+
+    // 在每个块边界之后找第一个顶层逗号
+    std::vector<size_t> commas(chunks, std::string_view::npos);
+    run(chunks - 1, [&](size_t i) {
+        commas[i] = scan(input, chunkBegin(i + 1), chunkEnd(i + 1), begin, inString[i + 1],
+                         depth[i + 1], true).comma;
+    });
+
+    std::vector<Piece> pieces;
+    for (size_t comma : commas) {
+        if (comma != std::string_view::npos) {
+            pieces.push_back(Piece{begin, comma});
+            begin = comma + 1;
+        }
+    }
+    pieces.push_back(Piece{begin, close});
+    return pieces;
+}
+
+JsonValue ParallelParser::parse(std::string_view input) {
+    auto serial = [&] {
+        pieces_ = 1;
+        return JsonParser(options_.parse).parse(input);
+    };
+
+    size_t open = 0;
+    while (open < input.size() && isWhitespace(input[open])) {
+        open++;
+    }
+    size_t close = input.size();
+    while (close > open && isWhitespace(input[close - 1])) {
+        close--;
+    }
+    if (!pool_ || close - open < 2) {
+        return serial();
+    }
+    bool isObject = input[open] == '{';
+    if (!(input[open] == '[' && input[close - 1] == ']') &&
+        !(isObject && input[close - 1] == '}')) {
+        return serial();
+    }
+    close--;
+
+    checkInput(input, options_.parse);
+    std::vector<Piece> pieces = split(input, open, close);
+    if (pieces.size() < 2) {
+        return serial();
+    }
+
+    // 每段按容器内部的成员序列解析；任何一段失败都交给串行解析器报告同样的错误
+    std::vector<JsonValue::Array> arrays(isObject ? 0 : pieces.size());
+    std::vector<JsonValue::Object> objects(isObject ? pieces.size() : 0);
+    std::atomic<bool> failed{false};
+    run(pieces.size(), [&](size_t i) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        try {
+            JsonLexer lexer(input.substr(pieces[i].begin, pieces[i].end - pieces[i].begin),
+                            ScanMode::Indexed);
+            ValueBuilder builder;
+            if (isObject) {
+                builder.onStartObject();
+            } else {
+                builder.onStartArray();
+            }
+            SaxReader<ValueBuilder> reader(lexer, builder, options_.parse.maxDepth);
+            reader.parseMembers(isObject);
+            if (isObject) {
+                objects[i] = builder.takeObject();
+            } else {
+                arrays[i] = builder.takeArray();
+            }
+        } catch (const ParserError&) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+    if (failed.load()) {
+        return serial();
+    }
+    pieces_ = pieces.size();
+
+    if (isObject) {
+        // 逐个赋值，重复键与串行解析一样保留首次出现的位置和最后的值
+        JsonValue::Object object = std::move(objects[0]);
+        for (size_t i = 1; i < objects.size(); ++i) {
+            for (auto& member : objects[i]) {
+                object[std::move(member.first)] = std::move(member.second);
+            }
+            objects[i].clear();
+        }
+        return JsonValue(std::move(object));
+    }
+
+    // 数组按前缀和定位，各段并行移动到最终位置
+    std::vector<size_t> offsets(arrays.size() + 1, 0);
+    for (size_t i = 0; i < arrays.size(); ++i) {
+        offsets[i + 1] = offsets[i] + arrays[i].size();
+    }
+    JsonValue::Array array(offsets.back());
+    run(arrays.size(), [&](size_t i) {
+        std::move(arrays[i].begin(), arrays[i].end(), array.begin() + offsets[i]);
+        JsonValue::Array().swap(arrays[i]);
+    });
+    return JsonValue(std::move(array));
+}
+
+} // namespace json
@@ -1,123 +1,98 @@
 #include "json_parser.h"
-#include <sstream>
+#include "json_sax.h"
+#include "json_document.h"
 
 namespace json {
 
-JsonParser::JsonParser(const std::string& input)
-    : lexer_(std::make_unique<JsonLexer>(input)) {
-    advance();
-}
-
-JsonValue JsonParser::parse() {
-    JsonValue value = parseValue();
-    
-    if (current_.type != TokenType::END_OF_FILE) {
-        throw ParserError("Expected end of file");
+void checkInput(std::string_view input, const ParseOptions& options) {
+    size_t offset = 0;
+    if (options.validateUtf8 && !validateUtf8(input, &offset)) {
+        SourceLocation location = JsonLexer(input).locate(offset);
+        throw ParserError("Invalid UTF-8 at line " + std::to_string(location.line) +
+                          ", column " + std::to_string(location.column));
     }
-    
-    return value;
 }
 
-void JsonParser::advance() {
-    previous_ = current_;
-    current_ = lexer_->nextToken();
-}
+namespace {
 
-bool JsonParser::check(TokenType type) const {
-    return current_.type == type;
-}
-
-bool JsonParser::match(TokenType type) {
-    if (check(type)) {
-        advance();
-        return true;
+// 记录一次解析的总耗时，未单独计时的部分计入 Building；解析出错时同样生效
+class ParseScope {
+public:
+    ParseScope(ParseStats& stats, size_t bytes) : stats_(stats) {
+        if constexpr (kStatsEnabled) {
+            stats_ = ParseStats();
+            stats_.parses = 1;
+            stats_.bytes[static_cast<size_t>(ParsePhase::Lexing)] = bytes;
+            start_ = readCycleCounter();
+        }
     }
-    return false;
-}
 
-Token JsonParser::consume(TokenType type, const std::string& message) {
-    if (check(type)) {
-        Token token = current_;
-        advance();
-        return token;
+    ~ParseScope() {
+        if constexpr (kStatsEnabled) {
+            uint64_t total = readCycleCounter() - start_;
+            uint64_t timed = stats_.totalCycles();
+            stats_.cycles[static_cast<size_t>(ParsePhase::Building)] = total > timed ? total - timed : 0;
+        }
     }
-    
-    std::stringstream ss;
-    ss << message << " at line " << current_.line << ", column " << current_.column;
-    throw ParserError(ss.str());
-}
 
-JsonValue JsonParser::parseValue() {
-    switch (current_.type) {
-        case TokenType::LEFT_BRACE:
-            return parseObject();
-        case TokenType::LEFT_BRACKET:
-            return parseArray();
-        case TokenType::STRING:
-            return parseString();
-        case TokenType::NUMBER:
-            return parseNumber();
-        case TokenType::TRUE:
-            advance();
-            return JsonValue(true);
-        case TokenType::FALSE:
-            advance();
-            return JsonValue(false);
-        case TokenType::NULL_:
-            advance();
-            return JsonValue(nullptr);
-        default:
-            throw ParserError("Unexpected token");
-    }
-}
+private:
+    ParseStats& stats_;
+    uint64_t start_ = 0;
+};
 
-JsonValue JsonParser::parseObject() {
-    JsonValue::Object object;
-    
-    advance(); // Consume left brace
-    
-    if (!check(TokenType::RIGHT_BRACE)) {
-        do {
-            // Parse key
-            Token key = consume(TokenType::STRING, "Expected string key");
-            
-            // Parse colon
-            consume(TokenType::COLON, "Expected ':' after key");
-            
-            // Parse value
-            object[key.value] = parseValue();
-        } while (match(TokenType::COMMA));
-    }
-    
-    consume(TokenType::RIGHT_BRACE, "Expected '}' after object");
-    return JsonValue(std::move(object));
+} // namespace
+
+JsonParser::JsonParser(const ParseOptions& options)
+    : options_(options), lexer_(std::string_view(), ScanMode::Indexed) {}
+
+JsonParser::JsonParser(std::string_view input, const ParseOptions& options)
+    : input_(input), options_(options), lexer_(std::string_view(), ScanMode::Indexed) {}
+
+JsonParser::~JsonParser() = default;
+
+JsonValue JsonParser::parse() {
+    return parse(input_);
 }
 
-JsonValue JsonParser::parseArray() {
-    JsonValue::Array array;
-    
-    advance(); // Consume left bracket
-    
-    if (!check(TokenType::RIGHT_BRACKET)) {
-        do {
-            array.push_back(parseValue());
-        } while (match(TokenType::COMMA));
+void JsonParser::start(std::string_view input) {
+    {
+        PhaseTimer timer(statsTarget(), ParsePhase::Validation, options_.validateUtf8 ? input.size() : 0);
+        checkInput(input, options_);
     }
-    
-    consume(TokenType::RIGHT_BRACKET, "Expected ']' after array");
-    return JsonValue(std::move(array));
+    PhaseTimer timer(statsTarget(), ParsePhase::Indexing, input.size());
+    lexer_.reset(input);
 }
 
-JsonValue JsonParser::parseString() {
-    JsonValue value(current_.value);
-    advance();
-    return value;
+JsonValue JsonParser::parse(std::string_view input) {
+    ParseScope scope(stats_, input.size());
+    start(input);
+    ValueBuilder builder(statsTarget());
+    SaxReader<ValueBuilder> reader(lexer_, builder, buffers_, options_.maxDepth, statsTarget());
+    reader.parse();
+    return builder.take();
 }
 
-JsonValue JsonParser::parseNumber() {
-    double number = std::stod(current_.value);
-    advance();
-    return JsonValue(number);
+void JsonParser::parse(std::string_view input, Document& doc) {
+    ParseScope scope(stats_, input.size());
+    start(input);
+    // 复用文档的arena和构建器的临时栈
+    doc.arena_.reset();
+    size_t blocks = doc.arena_.blockCount();
+    size_t reserved = doc.arena_.bytesReserved();
+    if (!documentBuilder_) {
+        documentBuilder_ = std::make_unique<DocumentBuilder>(doc.arena_, std::string_view(), options_.keys);
+    } else {
+        documentBuilder_->reset(doc.arena_, std::string_view(), options_.keys);
+    }
+    doc.root_ = DocValue();
+    SaxReader<DocumentBuilder> reader(lexer_, *documentBuilder_, buffers_, options_.maxDepth,
+                                      statsTarget());
+    reader.parse();
+    doc.root_ = documentBuilder_->root();
+    if constexpr (kStatsEnabled) {
+        stats_.allocations += doc.arena_.blockCount() - blocks;
+        stats_.allocatedBytes += doc.arena_.bytesReserved() - reserved;
+    }
 }
 
-} // namespace json 
\ No newline at end of file
+} // namespace json
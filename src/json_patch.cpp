@@ -0,0 +1,271 @@
+#include "json_patch.h"
+#include "json_query.h"
+#include <algorithm>
+#include <vector>
+
+namespace json {
+
+namespace {
+
+using Tokens = std::vector<std::string>;
+
+[[noreturn]] void fail(size_t op, const std::string& message) {
+    throw PatchError("Patch operation " + std::to_string(op) + ": " + message);
+}
+
+std::string pointerText(const Tokens& tokens, size_t count) {
+    std::string pointer;
+    for (size_t i = 0; i < count; ++i) {
+        appendPointerToken(pointer, tokens[i]);
+    }
+    return "'" + pointer + "'";
+}
+
+const JsonValue& member(size_t op, const JsonValue& operation, const char* name) {
+    auto it = operation.asObject().find(name);
+    if (it == operation.asObject().end()) {
+        fail(op, std::string("missing \"") + name + "\"");
+    }
+    return it->second;
+}
+
+Tokens pointerMember(size_t op, const JsonValue& operation, const char* name) {
+    const JsonValue& pointer = member(op, operation, name);
+    if (!pointer.isString()) {
+        fail(op, std::string("\"") + name + "\" must be a string");
+    }
+    try {
+        return splitPointer(pointer.asString());
+    } catch (const QueryError& e) {
+        fail(op, e.what());
+    }
+}
+
+// 容器中名为 token 的子值，不存在时返回 nullptr
+const PersistentValue* child(const PersistentValue& container, const std::string& token) {
+    if (container.isObject()) {
+        return container.find(token);
+    }
+    if (container.isArray()) {
+        size_t index = pointerIndex(token);
+        return index < container.size() ? &container.at(index) : nullptr;
+    }
+    return nullptr;
+}
+
+// 沿路径前 count 段向下，用 change 替换末端的值，再自底向上只复制路径上的容器
+template <typename Change>
+PersistentValue update(size_t op, const PersistentValue& root, const Tokens& tokens, size_t count,
+                       Change&& change) {
+    std::vector<const PersistentValue*> path{&root};
+    for (size_t i = 0; i < count; ++i) {
+        const PersistentValue* next = child(*path.back(), tokens[i]);
+        if (!next) {
+            fail(op, "path " + pointerText(tokens, i + 1) + " does not exist");
+        }
+        path.push_back(next);
+    }
+    PersistentValue value = change(*path.back());
+    for (size_t i = count; i-- > 0;) {
+        const PersistentValue& parent = *path[i];
+        value = parent.isObject() ? parent.setMember(tokens[i], std::move(value))
+                                  : parent.setElement(pointerIndex(tokens[i]), std::move(value));
+    }
+    return value;
+}
+
+const PersistentValue& get(size_t op, const PersistentValue& root, const Tokens& tokens) {
+    const PersistentValue* value = &root;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        value = child(*value, tokens[i]);
+        if (!value) {
+            fail(op, "path " + pointerText(tokens, i + 1) + " does not exist");
+        }
+    }
+    return *value;
+}
+
+PersistentValue add(size_t op, const PersistentValue& root, const Tokens& tokens,
+                    const PersistentValue& value) {
+    if (tokens.empty()) {
+        return value;
+    }
+    return update(op, root, tokens, tokens.size() - 1, [&](const PersistentValue& parent) {
+        const std::string& last = tokens.back();
+        if (parent.isObject()) {
+            return parent.setMember(last, value);
+        }
+        if (!parent.isArray()) {
+            fail(op, "parent of " + pointerText(tokens, tokens.size()) + " is not a container");
+        }
+        size_t index = last == "-" ? parent.size() : pointerIndex(last);
+        if (index > parent.size()) {
+            fail(op, "index " + pointerText(tokens, tokens.size()) + " is out of range");
+        }
+        return parent.insertElement(index, value);
+    });
+}
+
+PersistentValue remove(size_t op, const PersistentValue& root, const Tokens& tokens) {
+    if (tokens.empty()) {
+        fail(op, "cannot remove the document root");
+    }
+    return update(op, root, tokens, tokens.size() - 1, [&](const PersistentValue& parent) {
+        if (!child(parent, tokens.back())) {
+            fail(op, "path " + pointerText(tokens, tokens.size()) + " does not exist");
+        }
+        return parent.isObject() ? parent.eraseMember(tokens.back())
+                                 : parent.eraseElement(pointerIndex(tokens.back()));
+    });
+}
+
+PersistentValue replace(size_t op, const PersistentValue& root, const Tokens& tokens,
+                        const PersistentValue& value) {
+    get(op, root, tokens);
+    return update(op, root, tokens, tokens.size(), [&](const PersistentValue&) { return value; });
+}
+
+// 浮点数与整数的区别也算差异，这样 diff 的结果能精确还原目标
+bool sameScalar(const PersistentValue& a, const PersistentValue& b) {
+    if (a.isArray() || a.isObject() || b.isArray() || b.isObject()) {
+        return false;
+    }
+    return a.isDouble() == b.isDouble() && a == b;
+}
+
+JsonValue operation(const char* op, const std::string& path) {
+    JsonValue::Object object;
+    object.emplace("op", JsonValue(op));
+    object.emplace("path", JsonValue(path));
+    return JsonValue(std::move(object));
+}
+
+JsonValue operation(const char* op, const std::string& path, const PersistentValue& value) {
+    JsonValue::Object object;
+    object.emplace("op", JsonValue(op));
+    object.emplace("path", JsonValue(path));
+    object.emplace("value", value.toJson());
+    return JsonValue(std::move(object));
+}
+
+} // namespace
+
+PersistentValue applyPatch(const PersistentValue& document, const JsonValue& patch) {
+    if (!patch.isArray()) {
+        throw PatchError("Patch must be an array of operations");
+    }
+    PersistentValue result = document;
+    const JsonValue::Array& operations = patch.asArray();
+    for (size_t i = 0; i < operations.size(); ++i) {
+        const JsonValue& operation = operations[i];
+        if (!operation.isObject()) {
+            fail(i, "must be an object");
+        }
+        const JsonValue& op = member(i, operation, "op");
+        if (!op.isString()) {
+            fail(i, "\"op\" must be a string");
+        }
+        const std::string& name = op.asString();
+        Tokens path = pointerMember(i, operation, "path");
+
+        if (name == "add") {
+            result = add(i, result, path, PersistentValue(member(i, operation, "value")));
+        } else if (name == "remove") {
+            result = remove(i, result, path);
+        } else if (name == "replace") {
+            result = replace(i, result, path, PersistentValue(member(i, operation, "value")));
+        } else if (name == "move") {
+            Tokens from = pointerMember(i, operation, "from");
+            if (from.size() < path.size() && std::equal(from.begin(), from.end(), path.begin())) {
+                fail(i, "cannot move a value into itself");
+            }
+            PersistentValue value = get(i, result, from);
+            result = add(i, remove(i, result, from), path, value);
+        } else if (name == "copy") {
+            Tokens from = pointerMember(i, operation, "from");
+            result = add(i, result, path, get(i, result, from));
+        } else if (name == "test") {
+            if (get(i, result, path) != PersistentValue(member(i, operation, "value"))) {
+                fail(i, "test failed at " + pointerText(path, path.size()));
+            }
+        } else {
+            fail(i, "unknown operation \"" + name + "\"");
+        }
+    }
+    return result;
+}
+
+PersistentValue applyMergePatch(const PersistentValue& document, const JsonValue& patch) {
+    if (!patch.isObject()) {
+        return PersistentValue(patch);
+    }
+    PersistentValue result = document.isObject() ? document : PersistentValue::object();
+    for (const auto& entry : patch.asObject()) {
+        if (entry.second.isNull()) {
+            result = result.eraseMember(entry.first);
+            continue;
+        }
+        const PersistentValue* current = result.find(entry.first);
+        result = result.setMember(entry.first,
+                                  applyMergePatch(current ? *current : PersistentValue(), entry.second));
+    }
+    return result;
+}
+
+JsonValue diff(const PersistentValue& from, const PersistentValue& to) {
+    struct Pending {
+        const PersistentValue* from;
+        const PersistentValue* to;
+        std::string pointer;
+    };
+
+    // 深度优先遍历两个版本；共享的子树直接跳过。数组末尾的删除按下标从大到小，
+    // 不影响前面公共部分的路径，所以各操作的先后无关
+    JsonValue::Array operations;
+    std::vector<Pending> pending{Pending{&from, &to, std::string()}};
+    while (!pending.empty()) {
+        Pending item = std::move(pending.back());
+        pending.pop_back();
+        const PersistentValue& a = *item.from;
+        const PersistentValue& b = *item.to;
+        if (a.shares(b)) {
+            continue;
+        }
+
+        if (a.isObject() && b.isObject()) {
+            for (const auto& entry : a.members()) {
+                std::string pointer = item.pointer;
+                appendPointerToken(pointer, entry.first);
+                const PersistentValue* other = b.find(entry.first);
+                if (!other) {
+                    operations.push_back(operation("remove", pointer));
+                } else {
+                    pending.push_back(Pending{&entry.second, other, std::move(pointer)});
+                }
+            }
+            for (const auto& entry : b.members()) {
+                if (!a.find(entry.first)) {
+                    std::string pointer = item.pointer;
+                    appendPointerToken(pointer, entry.first);
+                    operations.push_back(operation("add", pointer, entry.second));
+                }
+            }
+        } else if (a.isArray() && b.isArray()) {
+            size_t common = std::min(a.size(), b.size());
+            for (size_t i = 0; i < common; ++i) {
+                pending.push_back(Pending{&a.at(i), &b.at(i), item.pointer + "/" + std::to_string(i)});
+            }
+            for (size_t i = a.size(); i-- > common;) {
+                operations.push_back(operation("remove", item.pointer + "/" + std::to_string(i)));
+            }
+            for (size_t i = common; i < b.size(); ++i) {
+                operations.push_back(operation("add", item.pointer + "/" + std::to_string(i), b.at(i)));
+            }
+        } else if (!sameScalar(a, b)) {
+            operations.push_back(operation("replace", item.pointer, b));
+        }
+    }
+    return JsonValue(std::move(operations));
+}
+
+} // namespace json
@@ -0,0 +1,370 @@
+#include "json_persistent.h"
+#include "json_hash.h"
+#include "json_number.h"
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+
+namespace json {
+
+namespace {
+
+constexpr size_t kIndexThreshold = 16;
+constexpr size_t npos = static_cast<size_t>(-1);
+
+size_t hashKey(std::string_view key) {
+    return std::hash<std::string_view>{}(key);
+}
+
+} // namespace
+
+// 数组节点；hash 为 0 表示尚未计算，多个线程同时计算时写入的是同一个值
+struct PersistentValue::ArrayData {
+    Array elements;
+    mutable std::atomic<uint64_t> hash{0};
+
+    explicit ArrayData(Array list) : elements(std::move(list)) {}
+};
+
+// 对象节点：成员按插入顺序存放，成员较多时附带开放寻址索引（槽位存位置 + 1）
+struct PersistentValue::ObjectData {
+    Members members;
+    std::vector<uint32_t> slots;
+    mutable std::atomic<uint64_t> hash{0};
+
+    explicit ObjectData(Members list) : members(std::move(list)) {
+        if (members.size() <= kIndexThreshold) {
+            return;
+        }
+        size_t capacity = 1;
+        while (capacity < members.size() * 2) {
+            capacity *= 2;
+        }
+        slots.assign(capacity, 0);
+        for (size_t i = 0; i < members.size(); ++i) {
+            size_t slot = hashKey(members[i].first) & (capacity - 1);
+            while (slots[slot]) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            slots[slot] = static_cast<uint32_t>(i + 1);
+        }
+    }
+
+    size_t findIndex(std::string_view key) const {
+        if (slots.empty()) {
+            for (size_t i = 0; i < members.size(); ++i) {
+                if (members[i].first == key) {
+                    return i;
+                }
+            }
+            return npos;
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hashKey(key) & mask; slots[slot]; slot = (slot + 1) & mask) {
+            if (members[slots[slot] - 1].first == key) {
+                return slots[slot] - 1;
+            }
+        }
+        return npos;
+    }
+};
+
+PersistentValue::PersistentValue(std::string str)
+    : value_(std::make_shared<const std::string>(std::move(str))) {}
+
+PersistentValue::PersistentValue(const JsonValue& value) : value_(nullptr) {
+    value.visit([this](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, JsonValue::Object>) {
+            Members members;
+            members.reserve(v.size());
+            for (const auto& member : v) {
+                members.emplace_back(member.first, PersistentValue(member.second));
+            }
+            *this = object(std::move(members));
+        } else if constexpr (std::is_same_v<T, JsonValue::Array>) {
+            Array elements;
+            elements.reserve(v.size());
+            for (const auto& element : v) {
+                elements.emplace_back(element);
+            }
+            *this = array(std::move(elements));
+        } else if constexpr (std::is_same_v<T, JsonValue::String>) {
+            *this = PersistentValue(v);
+        } else {
+            value_ = v;
+        }
+    });
+}
+
+PersistentValue PersistentValue::array(Array elements) {
+    PersistentValue result;
+    result.value_ = std::make_shared<const ArrayData>(std::move(elements));
+    return result;
+}
+
+PersistentValue PersistentValue::object(Members members) {
+    PersistentValue result;
+    result.value_ = std::make_shared<const ObjectData>(std::move(members));
+    return result;
+}
+
+JsonValue PersistentValue::toJson() const {
+    return std::visit([](const auto& v) -> JsonValue {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, ObjectNode>) {
+            JsonValue::Object object;
+            object.reserve(v->members.size());
+            for (const Member& member : v->members) {
+                object.emplace(member.first, member.second.toJson());
+            }
+            return JsonValue(std::move(object));
+        } else if constexpr (std::is_same_v<T, ArrayNode>) {
+            JsonValue::Array array;
+            array.reserve(v->elements.size());
+            for (const PersistentValue& element : v->elements) {
+                array.push_back(element.toJson());
+            }
+            return JsonValue(std::move(array));
+        } else if constexpr (std::is_same_v<T, StringNode>) {
+            return JsonValue(*v);
+        } else {
+            return JsonValue(v);
+        }
+    }, value_);
+}
+
+double PersistentValue::asNumber() const {
+    if (const int64_t* i = std::get_if<int64_t>(&value_)) {
+        return static_cast<double>(*i);
+    }
+    if (const uint64_t* u = std::get_if<uint64_t>(&value_)) {
+        return static_cast<double>(*u);
+    }
+    return std::get<double>(value_);
+}
+
+const PersistentValue::Array& PersistentValue::elements() const {
+    return std::get<ArrayNode>(value_)->elements;
+}
+
+const PersistentValue::ObjectData& PersistentValue::objectData() const {
+    return *std::get<ObjectNode>(value_);
+}
+
+const PersistentValue::Members& PersistentValue::members() const {
+    return objectData().members;
+}
+
+size_t PersistentValue::size() const {
+    if (isArray()) {
+        return elements().size();
+    }
+    if (isObject()) {
+        return members().size();
+    }
+    return 0;
+}
+
+const PersistentValue& PersistentValue::at(size_t index) const {
+    const Array& array = elements();
+    if (index >= array.size()) {
+        throw std::out_of_range("PersistentValue::at");
+    }
+    return array[index];
+}
+
+const PersistentValue* PersistentValue::find(std::string_view key) const {
+    if (!isObject()) {
+        return nullptr;
+    }
+    const ObjectData& data = objectData();
+    size_t index = data.findIndex(key);
+    return index == npos ? nullptr : &data.members[index].second;
+}
+
+// 以下更新都只复制当前这一层容器（浅复制），子节点与旧版本共享
+
+PersistentValue PersistentValue::setMember(std::string key, PersistentValue value) const {
+    const ObjectData& data = objectData();
+    Members members = data.members;
+    size_t index = data.findIndex(key);
+    if (index == npos) {
+        members.emplace_back(std::move(key), std::move(value));
+    } else {
+        members[index].second = std::move(value);
+    }
+    return object(std::move(members));
+}
+
+PersistentValue PersistentValue::eraseMember(std::string_view key) const {
+    const ObjectData& data = objectData();
+    size_t index = data.findIndex(key);
+    if (index == npos) {
+        return *this;
+    }
+    Members members;
+    members.reserve(data.members.size() - 1);
+    members.insert(members.end(), data.members.begin(), data.members.begin() + index);
+    members.insert(members.end(), data.members.begin() + index + 1, data.members.end());
+    return object(std::move(members));
+}
+
+PersistentValue PersistentValue::setElement(size_t index, PersistentValue value) const {
+    if (index >= elements().size()) {
+        throw std::out_of_range("PersistentValue::setElement");
+    }
+    Array array = elements();
+    array[index] = std::move(value);
+    return PersistentValue::array(std::move(array));
+}
+
+PersistentValue PersistentValue::insertElement(size_t index, PersistentValue value) const {
+    const Array& old = elements();
+    if (index > old.size()) {
+        throw std::out_of_range("PersistentValue::insertElement");
+    }
+    Array array;
+    array.reserve(old.size() + 1);
+    array.insert(array.end(), old.begin(), old.begin() + index);
+    array.push_back(std::move(value));
+    array.insert(array.end(), old.begin() + index, old.end());
+    return PersistentValue::array(std::move(array));
+}
+
+PersistentValue PersistentValue::eraseElement(size_t index) const {
+    const Array& old = elements();
+    if (index >= old.size()) {
+        throw std::out_of_range("PersistentValue::eraseElement");
+    }
+    Array array;
+    array.reserve(old.size() - 1);
+    array.insert(array.end(), old.begin(), old.begin() + index);
+    array.insert(array.end(), old.begin() + index + 1, old.end());
+    return PersistentValue::array(std::move(array));
+}
+
+bool PersistentValue::shares(const PersistentValue& other) const {
+    if (value_.index() != other.value_.index()) {
+        return false;
+    }
+    return std::visit([&other](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        return v == std::get<T>(other.value_);
+    }, value_);
+}
+
+bool PersistentValue::operator==(const PersistentValue& other) const {
+    if (shares(other)) {
+        return true;
+    }
+    if (isNumber() && other.isNumber()) {
+        auto number = [](const auto& value) {
+            NumberValue result;
+            if (const int64_t* i = std::get_if<int64_t>(&value)) {
+                result.i = *i;
+            } else if (const uint64_t* u = std::get_if<uint64_t>(&value)) {
+                result.kind = NumberValue::Kind::UInt64;
+                result.u = *u;
+            } else {
+                result.kind = NumberValue::Kind::Double;
+                result.d = std::get<double>(value);
+            }
+            return result;
+        };
+        return sameNumber(number(value_), number(other.value_));
+    }
+    if (value_.index() != other.value_.index()) {
+        return false;
+    }
+    // 两边都已缓存哈希时，哈希不同即可断定不相等
+    uint64_t a = cachedHash();
+    uint64_t b = other.cachedHash();
+    if (a != 0 && b != 0 && a != b) {
+        return false;
+    }
+    if (isString()) {
+        return asString() == other.asString();
+    }
+    if (isArray()) {
+        const Array& x = elements();
+        const Array& y = other.elements();
+        if (x.size() != y.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < x.size(); ++i) {
+            if (x[i] != y[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (isObject()) {
+        // 成员顺序不影响相等
+        const ObjectData& x = objectData();
+        const ObjectData& y = other.objectData();
+        if (x.members.size() != y.members.size()) {
+            return false;
+        }
+        for (const Member& member : x.members) {
+            size_t index = y.findIndex(member.first);
+            if (index == npos || member.second != y.members[index].second) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+uint64_t PersistentValue::cachedHash() const {
+    if (const ArrayNode* array = std::get_if<ArrayNode>(&value_)) {
+        return (*array)->hash.load(std::memory_order_relaxed);
+    }
+    if (const ObjectNode* object = std::get_if<ObjectNode>(&value_)) {
+        return (*object)->hash.load(std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+uint64_t PersistentValue::hash() const {
+    return std::visit([](const auto& v) -> uint64_t {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, ObjectNode> || std::is_same_v<T, ArrayNode>) {
+            uint64_t cached = v->hash.load(std::memory_order_relaxed);
+            if (cached != 0) {
+                return cached;
+            }
+            uint64_t hash;
+            if constexpr (std::is_same_v<T, ObjectNode>) {
+                uint64_t sum = 0;
+                for (const Member& member : v->members) {
+                    sum = detail::objectHashAdd(sum, detail::hashString(member.first), member.second.hash());
+                }
+                hash = detail::objectHashFinish(sum, v->members.size());
+            } else {
+                uint64_t state = detail::arrayHashStart();
+                for (const PersistentValue& element : v->elements) {
+                    state = detail::arrayHashAdd(state, element.hash());
+                }
+                hash = detail::arrayHashFinish(state, v->elements.size());
+            }
+            v->hash.store(hash, std::memory_order_relaxed);
+            return hash;
+        } else if constexpr (std::is_same_v<T, StringNode>) {
+            return detail::hashString(*v);
+        } else if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            return detail::hashNull();
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return detail::hashBoolean(v);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            return detail::hashInteger(v);
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+            return detail::hashUnsigned(v);
+        } else {
+            return detail::hashDouble(v);
+        }
+    }, value_);
+}
+
+} // namespace json
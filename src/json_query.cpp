@@ -0,0 +1,452 @@
+#include "json_query.h"
+#include "json_lexer.h"
+#include "json_sax.h"
+#include <limits>
+#include <utility>
+
+namespace json {
+
+namespace {
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// 十进制数组下标；非法或溢出时返回 npos
+size_t parseIndex(std::string_view digits) {
+    const size_t npos = static_cast<size_t>(-1);
+    if (digits.empty() || (digits.size() > 1 && digits[0] == '0')) {
+        return npos;
+    }
+    size_t value = 0;
+    for (char c : digits) {
+        if (!isDigit(c)) {
+            return npos;
+        }
+        size_t digit = static_cast<size_t>(c - '0');
+        if (value > (std::numeric_limits<size_t>::max() - 1 - digit) / 10) {
+            return npos;
+        }
+        value = value * 10 + digit;
+    }
+    return value;
+}
+
+[[noreturn]] void pointerError(std::string_view pointer, const char* reason) {
+    throw QueryError("Invalid JSON Pointer '" + std::string(pointer) + "': " + reason);
+}
+
+[[noreturn]] void pathError(std::string_view path, const char* reason, size_t position) {
+    throw QueryError("Invalid JSONPath '" + std::string(path) + "': " + reason +
+                     " at position " + std::to_string(position));
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// JSON Pointer helpers
+
+std::vector<std::string> splitPointer(std::string_view pointer) {
+    if (!pointer.empty() && pointer[0] != '/') {
+        pointerError(pointer, "must be empty or start with '/'");
+    }
+
+    std::vector<std::string> tokens;
+    size_t pos = 0;
+    while (pos < pointer.size()) {
+        // 每个 '/' 之后是一个引用片段
+        size_t end = pointer.find('/', pos + 1);
+        if (end == std::string_view::npos) {
+            end = pointer.size();
+        }
+        std::string token;
+        for (size_t i = pos + 1; i < end; ++i) {
+            if (pointer[i] != '~') {
+                token += pointer[i];
+            } else if (i + 1 < end && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+                token += pointer[++i] == '0' ? '~' : '/';
+            } else {
+                pointerError(pointer, "'~' must be followed by '0' or '1'");
+            }
+        }
+        tokens.push_back(std::move(token));
+        pos = end;
+    }
+    return tokens;
+}
+
+void appendPointerToken(std::string& pointer, std::string_view token) {
+    pointer += '/';
+    for (char c : token) {
+        if (c == '~') {
+            pointer += "~0";
+        } else if (c == '/') {
+            pointer += "~1";
+        } else {
+            pointer += c;
+        }
+    }
+}
+
+size_t pointerIndex(std::string_view token) {
+    return parseIndex(token);
+}
+
+// ---------------------------------------------------------------------------
+// JsonPath
+
+JsonPath JsonPath::fromPointer(std::string_view pointer) {
+    JsonPath path;
+    path.text_.assign(pointer.data(), pointer.size());
+    for (std::string& token : splitPointer(pointer)) {
+        size_t index = parseIndex(token);
+        path.steps_.push_back(Step{Step::Kind::Token, std::move(token), index});
+    }
+    path.finish();
+    return path;
+}
+
+JsonPath JsonPath::fromJsonPath(std::string_view text) {
+    JsonPath path;
+    path.text_.assign(text.data(), text.size());
+    if (text.empty() || text[0] != '$') {
+        pathError(text, "expected '$'", 0);
+    }
+
+    size_t i = 1;
+    while (i < text.size()) {
+        if (text[i] == '.') {
+            // .name 或 .*
+            i++;
+            if (i < text.size() && text[i] == '*') {
+                path.steps_.push_back(Step{Step::Kind::Wildcard, {}, npos});
+                i++;
+                continue;
+            }
+            size_t start = i;
+            while (i < text.size() && text[i] != '.' && text[i] != '[') {
+                i++;
+            }
+            if (i == start) {
+                pathError(text, "expected member name", start);
+            }
+            path.steps_.push_back(Step{Step::Kind::Name, std::string(text.substr(start, i - start)), npos});
+            continue;
+        }
+        if (text[i] != '[') {
+            pathError(text, "expected '.' or '['", i);
+        }
+
+        // [*]、[下标] 或 ['name']
+        i++;
+        if (i < text.size() && text[i] == '*') {
+            path.steps_.push_back(Step{Step::Kind::Wildcard, {}, npos});
+            i++;
+        } else if (i < text.size() && (text[i] == '\'' || text[i] == '"')) {
+            char quote = text[i++];
+            std::string name;
+            while (i < text.size() && text[i] != quote) {
+                if (text[i] == '\\' && i + 1 < text.size()) {
+                    i++;
+                }
+                name += text[i++];
+            }
+            if (i == text.size()) {
+                pathError(text, "unterminated name", i);
+            }
+            i++;
+            path.steps_.push_back(Step{Step::Kind::Name, std::move(name), npos});
+        } else {
+            size_t start = i;
+            while (i < text.size() && isDigit(text[i])) {
+                i++;
+            }
+            size_t index = parseIndex(text.substr(start, i - start));
+            if (index == npos) {
+                pathError(text, "expected index, quoted name or '*'", start);
+            }
+            path.steps_.push_back(Step{Step::Kind::Index, {}, index});
+        }
+        if (i == text.size() || text[i] != ']') {
+            pathError(text, "expected ']'", i);
+        }
+        i++;
+    }
+    path.finish();
+    return path;
+}
+
+void JsonPath::finish() {
+    prefix_ = 0;
+    while (prefix_ < steps_.size() && steps_[prefix_].kind != Step::Kind::Wildcard) {
+        prefix_++;
+    }
+}
+
+const JsonValue* JsonPath::find(const JsonValue& root) const {
+    std::vector<const JsonValue*> out;
+    collect(root, 0, out, true);
+    return out.empty() ? nullptr : out.front();
+}
+
+std::vector<const JsonValue*> JsonPath::findAll(const JsonValue& root) const {
+    std::vector<const JsonValue*> out;
+    collect(root, 0, out, false);
+    return out;
+}
+
+void JsonPath::collect(const JsonValue& value, size_t step, std::vector<const JsonValue*>& out,
+                       bool firstOnly) const {
+    // 递归深度受路径长度限制，与文档深度无关
+    if (step == steps_.size()) {
+        out.push_back(&value);
+        return;
+    }
+    const Step& s = steps_[step];
+    if (value.isObject()) {
+        const JsonValue::Object& object = value.asObject();
+        if (s.kind == Step::Kind::Wildcard) {
+            for (const auto& member : object) {
+                collect(member.second, step + 1, out, firstOnly);
+                if (firstOnly && !out.empty()) {
+                    return;
+                }
+            }
+        } else if (s.kind != Step::Kind::Index) {
+            auto it = object.find(s.name);
+            if (it != object.end()) {
+                collect(it->second, step + 1, out, firstOnly);
+            }
+        }
+    } else if (value.isArray()) {
+        const JsonValue::Array& array = value.asArray();
+        if (s.kind == Step::Kind::Wildcard) {
+            for (const JsonValue& element : array) {
+                collect(element, step + 1, out, firstOnly);
+                if (firstOnly && !out.empty()) {
+                    return;
+                }
+            }
+        } else if (s.index < array.size()) {
+            collect(array[s.index], step + 1, out, firstOnly);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// QueryMatcher
+
+// 在事件流上匹配路径
+//
+// active_ 是按深度分段的栈：每个打开的值对应一段，记录前缀仍与其位置
+// 相符的路径。命中的值由 ValueBuilder 单独构建，其余部分只做词法扫描。
+class QueryMatcher final : public SaxHandler {
+public:
+    QueryMatcher(const std::vector<JsonPath>& paths, JsonQuery::Result& results)
+        : paths_(paths), results_(results), done_(paths.size(), false), remaining_(paths.size()) {
+        for (size_t i = 0; i < paths.size(); ++i) {
+            active_.push_back(i);
+        }
+        next_ = Range{0, active_.size()};
+    }
+
+    bool onNull() override {
+        Range range = beginValue();
+        forward([](ValueBuilder& b) { b.onNull(); });
+        return endValue(range);
+    }
+    bool onBoolean(bool value) override {
+        Range range = beginValue();
+        forward([value](ValueBuilder& b) { b.onBoolean(value); });
+        return endValue(range);
+    }
+    bool onNumber(double value) override {
+        Range range = beginValue();
+        forward([value](ValueBuilder& b) { b.onNumber(value); });
+        return endValue(range);
+    }
+    bool onInteger(int64_t value) override {
+        Range range = beginValue();
+        forward([value](ValueBuilder& b) { b.onInteger(value); });
+        return endValue(range);
+    }
+    bool onUnsigned(uint64_t value) override {
+        Range range = beginValue();
+        forward([value](ValueBuilder& b) { b.onUnsigned(value); });
+        return endValue(range);
+    }
+    bool onString(std::string_view value) override {
+        Range range = beginValue();
+        forward([value](ValueBuilder& b) { b.onString(value); });
+        return endValue(range);
+    }
+
+    bool onKey(std::string_view key) override {
+        forward([key](ValueBuilder& b) { b.onKey(key); });
+        next_ = select(frames_.back().range, [key](const JsonPath::Step& s) { return s.matchesKey(key); });
+        return true;
+    }
+
+    bool onStartObject() override {
+        frames_.push_back(Frame{true, 0, beginValue()});
+        forward([](ValueBuilder& b) { b.onStartObject(); });
+        return true;
+    }
+    bool onEndObject(size_t count) override {
+        forward([count](ValueBuilder& b) { b.onEndObject(count); });
+        Range range = frames_.back().range;
+        frames_.pop_back();
+        return endValue(range);
+    }
+    bool onStartArray() override {
+        frames_.push_back(Frame{false, 0, beginValue()});
+        forward([](ValueBuilder& b) { b.onStartArray(); });
+        return true;
+    }
+    bool onEndArray(size_t count) override {
+        forward([count](ValueBuilder& b) { b.onEndArray(count); });
+        Range range = frames_.back().range;
+        frames_.pop_back();
+        return endValue(range);
+    }
+
+private:
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+
+    struct Frame {
+        bool isObject;
+        size_t count;
+        Range range;  // Paths still matching this container
+    };
+
+    struct Capture {
+        ValueBuilder builder;
+        size_t depth;
+        size_t hitsBegin;  // Paths selecting the value, in hits_
+    };
+
+    const std::vector<JsonPath>& paths_;
+    JsonQuery::Result& results_;
+    std::vector<bool> done_;
+    size_t remaining_;
+
+    std::vector<size_t> active_;
+    std::vector<Frame> frames_;
+    Range next_;
+    std::vector<size_t> hits_;
+    std::vector<Capture> captures_;  // Builders are kept for reuse
+    size_t captureCount_ = 0;
+
+    template <typename Matches>
+    Range select(const Range& parent, Matches matches) {
+        // 丢弃上一个兄弟节点留下的段，再从父段筛选
+        size_t depth = frames_.size() - 1;
+        active_.resize(parent.end);
+        for (size_t i = parent.begin; i < parent.end; ++i) {
+            size_t id = active_[i];
+            const std::vector<JsonPath::Step>& steps = paths_[id].steps_;
+            if (!done_[id] && depth < steps.size() && matches(steps[depth])) {
+                active_.push_back(id);
+            }
+        }
+        return Range{parent.end, active_.size()};
+    }
+
+    Range beginValue() {
+        Range range = next_;
+        if (!frames_.empty() && !frames_.back().isObject) {
+            size_t index = frames_.back().count++;
+            range = select(frames_.back().range, [index](const JsonPath::Step& s) { return s.matchesIndex(index); });
+        }
+
+        // 路径在此结束的值开始构建
+        size_t depth = frames_.size();
+        size_t hitsBegin = hits_.size();
+        for (size_t i = range.begin; i < range.end; ++i) {
+            if (paths_[active_[i]].steps_.size() == depth) {
+                hits_.push_back(active_[i]);
+            }
+        }
+        if (hits_.size() > hitsBegin) {
+            if (captureCount_ == captures_.size()) {
+                captures_.emplace_back();
+            }
+            Capture& capture = captures_[captureCount_++];
+            capture.builder.reset();
+            capture.depth = depth;
+            capture.hitsBegin = hitsBegin;
+        }
+        return range;
+    }
+
+    bool endValue(const Range& range) {
+        size_t depth = frames_.size();
+        if (captureCount_ > 0 && captures_[captureCount_ - 1].depth == depth) {
+            Capture& capture = captures_[--captureCount_];
+            JsonValue value = capture.builder.take();
+            for (size_t i = capture.hitsBegin; i < hits_.size(); ++i) {
+                if (i + 1 < hits_.size()) {
+                    results_[hits_[i]].push_back(value);
+                } else {
+                    results_[hits_[i]].push_back(std::move(value));
+                }
+            }
+            hits_.resize(capture.hitsBegin);
+        }
+
+        // 通配符之前的每一步只取第一个匹配，这些值结束后路径不会再有新的匹配
+        for (size_t i = range.begin; i < range.end; ++i) {
+            size_t id = active_[i];
+            if (!done_[id] && paths_[id].prefix_ >= depth) {
+                done_[id] = true;
+                remaining_--;
+            }
+        }
+        return remaining_ > 0;
+    }
+
+    template <typename Event>
+    void forward(Event event) {
+        for (size_t i = 0; i < captureCount_; ++i) {
+            event(captures_[i].builder);
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// JsonQuery
+
+size_t JsonQuery::add(JsonPath path) {
+    paths_.push_back(std::move(path));
+    return paths_.size() - 1;
+}
+
+JsonQuery::Result JsonQuery::evaluate(const JsonValue& root) const {
+    Result results(paths_.size());
+    for (size_t i = 0; i < paths_.size(); ++i) {
+        for (const JsonValue* value : paths_[i].findAll(root)) {
+            results[i].push_back(*value);
+        }
+    }
+    return results;
+}
+
+JsonQuery::Result JsonQuery::scan(std::string_view input, const ParseOptions& options) const {
+    Result results(paths_.size());
+    if (paths_.empty()) {
+        return results;
+    }
+    checkInput(input, options);
+
+    // 顺序扫描：提前停止时不必为剩余输入建立结构索引
+    JsonLexer lexer(input);
+    QueryMatcher matcher(paths_, results);
+    SaxReader<QueryMatcher> reader(lexer, matcher, options.maxDepth);
+    reader.parse();
+    return results;
+}
+
+} // namespace json
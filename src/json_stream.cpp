@@ -0,0 +1,291 @@
+#include "json_stream.h"
+#include "json_parser.h"
+#include <cstring>
+#include <sstream>
+
+namespace json {
+
+namespace {
+
+// Bytes that can continue a number or literal
+bool isScalarChar(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           c == '+' || c == '-' || c == '.';
+}
+
+// Tokens that may continue in the next chunk if they run up to its end
+bool isOpenEnded(TokenType type) {
+    return type == TokenType::NUMBER || type == TokenType::TRUE || type == TokenType::FALSE ||
+           type == TokenType::NULL_ || type == TokenType::ERROR;
+}
+
+} // namespace
+
+StreamingParser::StreamingParser(const ParseOptions& options)
+    : handler_(&builder_), maxDepth_(options.maxDepth), hasRoot_(false), stopped_(false),
+      pendingString_(false) {}
+
+StreamingParser::StreamingParser(SaxHandler& handler, const ParseOptions& options)
+    : handler_(&handler), maxDepth_(options.maxDepth), hasRoot_(false), stopped_(false),
+      pendingString_(false) {}
+
+void StreamingParser::reset() {
+    builder_.reset();
+    stack_.clear();
+    hasRoot_ = false;
+    stopped_ = false;
+    pending_.clear();
+    pendingString_ = false;
+    pendingBase_ = Position();
+    base_ = Position();
+    segment_ = std::string_view();
+    segmentBase_ = Position();
+}
+
+void StreamingParser::feed(std::string_view chunk) {
+    if (stopped_) {
+        base_ = advancePosition(base_, chunk, chunk.size());
+        return;
+    }
+
+    std::string_view rest = chunk;
+    Position restBase = base_;
+
+    if (!pending_.empty()) {
+        // 先补全上一块末尾被截断的词法单元
+        size_t end = findPendingEnd(chunk);
+        if (end == std::string_view::npos) {
+            pending_.append(chunk.data(), chunk.size());
+            base_ = advancePosition(base_, chunk, chunk.size());
+            return;
+        }
+        pending_.append(chunk.data(), end);
+        lexSegment(pending_, pendingBase_, false);
+        pending_.clear();
+        rest = chunk.substr(end);
+        restBase = advancePosition(base_, chunk, end);
+    }
+
+    lexSegment(rest, restBase, true);
+    base_ = advancePosition(base_, chunk, chunk.size());
+}
+
+JsonValue StreamingParser::finish() {
+    if (!stopped_ && !pending_.empty()) {
+        std::string last = std::move(pending_);
+        pending_.clear();
+        lexSegment(last, pendingBase_, false);
+    }
+
+    if (!stopped_) {
+        segment_ = std::string_view();
+        segmentBase_ = base_;
+        onToken(Token{TokenType::END_OF_FILE, {}, false, 0});
+    }
+
+    JsonValue result = builder_.take();
+    reset();
+    return result;
+}
+
+size_t StreamingParser::findPendingEnd(std::string_view chunk) const {
+    if (!pendingString_) {
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            if (!isScalarChar(chunk[i])) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    // 末尾连续反斜杠为奇数个时，下一块的首字节被转义
+    size_t backslashes = 0;
+    for (size_t i = pending_.size(); i > 1 && pending_[i - 1] == '\\'; --i) {
+        backslashes++;
+    }
+    bool escaped = (backslashes % 2) == 1;
+    for (size_t i = 0; i < chunk.size(); ++i) {
+        char c = chunk[i];
+        if (escaped) {
+            escaped = false;
+        } else if (c == '\\') {
+            escaped = true;
+        } else if (c == '"') {
+            return i + 1;
+        }
+    }
+    return std::string_view::npos;
+}
+
+void StreamingParser::lexSegment(std::string_view text, const Position& base, bool mayContinue) {
+    JsonLexer lexer(text);
+    segment_ = text;
+    segmentBase_ = base;
+
+    while (!stopped_) {
+        Token token = lexer.nextToken();
+        if (token.type == TokenType::END_OF_FILE) {
+            return;
+        }
+        if (mayContinue && lexer.position() == text.size() && isOpenEnded(token.type)) {
+            // 词法单元到达块末尾，可能尚未结束，留到下一块
+            pending_.assign(text.data() + token.offset, text.size() - token.offset);
+            pendingString_ = text[token.offset] == '"';
+            pendingBase_ = advancePosition(base, text, token.offset);
+            return;
+        }
+        onToken(token);
+    }
+}
+
+void StreamingParser::onToken(const Token& token) {
+    if (stack_.empty()) {
+        if (hasRoot_) {
+            if (token.type == TokenType::END_OF_FILE) {
+                return;
+            }
+            throw ParserError("Expected end of file");
+        }
+        beginValue(token);
+        return;
+    }
+
+    Frame& top = stack_.back();
+    switch (top.state) {
+        case State::FirstValueOrEnd:
+            if (token.type == TokenType::RIGHT_BRACKET) {
+                closeContainer();
+                return;
+            }
+            beginValue(token);
+            return;
+        case State::Value:
+            beginValue(token);
+            return;
+        case State::FirstKeyOrEnd:
+            if (token.type == TokenType::RIGHT_BRACE) {
+                closeContainer();
+                return;
+            }
+            [[fallthrough]];
+        case State::Key:
+            if (token.type != TokenType::STRING) {
+                fail("Expected string key", token);
+            }
+            top.state = State::Colon;
+            report(handler_->onKey(decode(token)));
+            return;
+        case State::Colon:
+            if (token.type != TokenType::COLON) {
+                fail("Expected ':' after key", token);
+            }
+            top.state = State::Value;
+            return;
+        case State::CommaOrEnd:
+            if (token.type == TokenType::COMMA) {
+                top.state = top.isObject ? State::Key : State::Value;
+                return;
+            }
+            if (top.isObject) {
+                if (token.type != TokenType::RIGHT_BRACE) {
+                    fail("Expected '}' after object", token);
+                }
+            } else if (token.type != TokenType::RIGHT_BRACKET) {
+                fail("Expected ']' after array", token);
+            }
+            closeContainer();
+            return;
+    }
+}
+
+std::string_view StreamingParser::decode(const Token& token) {
+    if (!token.escaped) {
+        return token.value;
+    }
+    scratch_.clear();
+    JsonLexer::unescape(token.value, scratch_);
+    return scratch_;
+}
+
+void StreamingParser::beginValue(const Token& token) {
+    if ((token.type == TokenType::LEFT_BRACE || token.type == TokenType::LEFT_BRACKET) &&
+        stack_.size() >= maxDepth_) {
+        fail("Maximum nesting depth exceeded", token);
+    }
+    switch (token.type) {
+        case TokenType::LEFT_BRACE:
+            stack_.push_back(Frame{true, State::FirstKeyOrEnd, 0});
+            report(handler_->onStartObject());
+            return;
+        case TokenType::LEFT_BRACKET:
+            stack_.push_back(Frame{false, State::FirstValueOrEnd, 0});
+            report(handler_->onStartArray());
+            return;
+        case TokenType::STRING:
+            valueDone();
+            report(handler_->onString(decode(token)));
+            return;
+        case TokenType::NUMBER: {
+            NumberValue number = parseNumber(token.value);
+            valueDone();
+            report(detail::reportNumber(*handler_, number));
+            return;
+        }
+        case TokenType::TRUE:
+        case TokenType::FALSE:
+            valueDone();
+            report(handler_->onBoolean(token.type == TokenType::TRUE));
+            return;
+        case TokenType::NULL_:
+            valueDone();
+            report(handler_->onNull());
+            return;
+        case TokenType::ERROR:
+            fail(std::string(token.value), token);
+        default:
+            throw ParserError("Unexpected token");
+    }
+}
+
+void StreamingParser::valueDone() {
+    if (stack_.empty()) {
+        hasRoot_ = true;
+        return;
+    }
+    Frame& top = stack_.back();
+    top.count++;
+    top.state = State::CommaOrEnd;
+}
+
+void StreamingParser::closeContainer() {
+    Frame frame = stack_.back();
+    stack_.pop_back();
+    valueDone();
+    report(frame.isObject ? handler_->onEndObject(frame.count) : handler_->onEndArray(frame.count));
+}
+
+void StreamingParser::fail(const std::string& message, const Token& token) const {
+    Position position = advancePosition(segmentBase_, segment_, token.offset);
+    std::stringstream ss;
+    ss << message << " at line " << position.line << ", column "
+       << (position.offset - position.lineStart + 1);
+    throw ParserError(ss.str());
+}
+
+StreamingParser::Position StreamingParser::advancePosition(Position position, std::string_view text, size_t count) {
+    const char* data = text.data();
+    size_t i = 0;
+    while (i < count) {
+        const void* nl = std::memchr(data + i, '\n', count - i);
+        if (!nl) {
+            break;
+        }
+        i = static_cast<size_t>(static_cast<const char*>(nl) - data) + 1;
+        position.line++;
+        position.lineStart = position.offset + i;
+    }
+    position.offset += count;
+    return position;
+}
+
+} // namespace json
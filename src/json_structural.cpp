@@ -0,0 +1,491 @@
+#include "json_structural.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JSON_STRUCTURAL_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+#define JSON_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#define JSON_ALWAYS_INLINE inline
+#endif
+
+namespace json {
+
+namespace {
+
+// Bit masks for one 64-byte block, bit i describes byte i
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;          // { } [ ] , :
+    uint64_t whitespace;  // space, \t, \n, \r
+};
+
+// State carried from one block to the next
+struct ScanState {
+    uint64_t prevEscaped = 0;   // first byte of the next block is escaped
+    uint64_t prevInString = 0;  // all ones while inside a string
+    uint64_t prevScalar = 0;    // last byte of the block was a scalar byte
+};
+
+inline bool isJsonOp(unsigned char c) {
+    return c == '{' || c == '}' || c == '[' || c == ']' || c == ',' || c == ':';
+}
+
+inline bool isJsonWhitespace(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline int countTrailingZeros(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+inline int popCount(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    int n = 0;
+    while (x) { x &= x - 1; ++n; }
+    return n;
+#endif
+}
+
+inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Bytes preceded by an odd run of backslashes (escape handling as in
+// simdjson: runs starting on even and odd bits are resolved with one add).
+inline uint64_t findEscaped(uint64_t backslash, ScanState& state) {
+    backslash &= ~state.prevEscaped;
+    uint64_t followsEscape = (backslash << 1) | state.prevEscaped;
+    const uint64_t evenBits = 0x5555555555555555ULL;
+    uint64_t oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+    uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+    state.prevEscaped = sequencesStartingOnEvenBits < oddSequenceStarts ? 1 : 0;
+    uint64_t invertMask = sequencesStartingOnEvenBits << 1;
+    return (evenBits ^ invertMask) & followsEscape;
+}
+
+// Turn the raw character masks of a block into its structural mask
+inline uint64_t structuralMask(const BlockMasks& m, ScanState& state) {
+    uint64_t escaped = findEscaped(m.backslash, state);
+    uint64_t quote = m.quote & ~escaped;
+
+    // 引号之间（含开引号，不含闭引号）的位为1
+    uint64_t inString = prefixXor(quote) ^ state.prevInString;
+    state.prevInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+    uint64_t scalar = ~(m.op | m.whitespace);
+    uint64_t nonQuoteScalar = scalar & ~quote;
+    uint64_t followsScalar = (nonQuoteScalar << 1) | state.prevScalar;
+    state.prevScalar = nonQuoteScalar >> 63;
+    uint64_t scalarStart = nonQuoteScalar & ~followsScalar;
+
+    return ((m.op | scalarStart) & ~inString) | quote;
+}
+
+inline void appendPositions(uint64_t mask, uint32_t base, std::vector<uint32_t>& out) {
+    if (!mask) return;
+    size_t n = out.size();
+    out.resize(n + static_cast<size_t>(popCount(mask)));
+    uint32_t* dst = out.data() + n;
+    while (mask) {
+        *dst++ = base + static_cast<uint32_t>(countTrailingZeros(mask));
+        mask &= mask - 1;
+    }
+}
+
+// Drive a block classifier over the input; the tail is copied into a
+// space-padded block so kernels never read past the end of the buffer.
+template <typename Classify>
+bool scanBlocks(std::string_view input, std::vector<uint32_t>& out, Classify classify) {
+    ScanState state;
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(input.data());
+    size_t size = input.size();
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        BlockMasks m = classify(data + i);
+        appendPositions(structuralMask(m, state), static_cast<uint32_t>(i), out);
+    }
+    if (i < size) {
+        alignas(64) unsigned char tail[64];
+        std::memset(tail, ' ', sizeof(tail));
+        std::memcpy(tail, data + i, size - i);
+        BlockMasks m = classify(tail);
+        appendPositions(structuralMask(m, state), static_cast<uint32_t>(i), out);
+    }
+    return state.prevInString != 0;
+}
+
+// Portable fallback: a byte-at-a-time state machine with the same output
+bool scanScalar(std::string_view input, std::vector<uint32_t>& out) {
+    bool inString = false;
+    bool escapeNext = false;
+    bool prevScalar = false;
+    for (size_t i = 0; i < input.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(input[i]);
+        bool isEscaped = escapeNext;
+        escapeNext = (c == '\\' && !isEscaped);
+        if (c == '"' && !isEscaped) {
+            out.push_back(static_cast<uint32_t>(i));
+            inString = !inString;
+            prevScalar = false;
+            continue;
+        }
+        bool op = isJsonOp(c);
+        bool scalar = !op && !isJsonWhitespace(c);
+        if (!inString && (op || (scalar && !prevScalar))) {
+            out.push_back(static_cast<uint32_t>(i));
+        }
+        prevScalar = scalar;
+    }
+    return inString;
+}
+
+size_t findStringSpecialScalar(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (c == '"' || c == '\\' || c < 0x20) {
+            return i;
+        }
+    }
+    return size;
+}
+
+// 校验失败时在返回的偏移量上置位
+constexpr size_t kUtf8Error = size_t(1) << (sizeof(size_t) * 8 - 1);
+
+// Length of the UTF-8 sequence starting at data[0], or 0 if it is malformed
+inline size_t utf8SequenceLength(const unsigned char* data, size_t size) {
+    unsigned char c = data[0];
+    if (c < 0x80) return 1;
+
+    size_t length;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+        length = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        length = 3;
+        if (c == 0xE0) low = 0xA0;        // 过长编码
+        else if (c == 0xED) high = 0x9F;  // 代理区
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        length = 4;
+        if (c == 0xF0) low = 0x90;        // 过长编码
+        else if (c == 0xF4) high = 0x8F;  // 超过U+10FFFF
+    } else {
+        return 0;
+    }
+
+    if (size < length) return 0;
+    if (data[1] < low || data[1] > high) return 0;
+    for (size_t i = 2; i < length; ++i) {
+        if ((data[i] & 0xC0) != 0x80) return 0;
+    }
+    return length;
+}
+
+// 从 i 开始逐个校验非ASCII序列，直到遇到ASCII字节；出错时返回带 kUtf8Error 标记的位置
+// 内联进各个向量内核，避免在向量代码中调用外部函数
+JSON_ALWAYS_INLINE size_t validateNonAscii(const unsigned char* data, size_t size, size_t i) {
+    while (i < size && (data[i] & 0x80)) {
+        size_t length = utf8SequenceLength(data + i, size - i);
+        if (length == 0) {
+            return i | kUtf8Error;
+        }
+        i += length;
+    }
+    return i;
+}
+
+size_t validateUtf8Scalar(const unsigned char* data, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+        if (data[i] & 0x80) {
+            i = validateNonAscii(data, size, i);
+            if (i & kUtf8Error) {
+                return i;
+            }
+        } else {
+            i++;
+        }
+    }
+    return i;
+}
+
+#ifdef JSON_STRUCTURAL_X86
+
+__attribute__((target("sse2")))
+BlockMasks classifySse2(const unsigned char* p) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lowerBit = _mm_set1_epi8(0x20);
+    const __m128i openBrace = _mm_set1_epi8('{');
+    const __m128i closeBrace = _mm_set1_epi8('}');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+
+    BlockMasks m{0, 0, 0, 0};
+    for (int k = 0; k < 4; ++k) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+        // '[' | 0x20 == '{' and ']' | 0x20 == '}'
+        __m128i folded = _mm_or_si128(v, lowerBit);
+        __m128i op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, colon)));
+        __m128i ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, cr)));
+        int shift = 16 * k;
+        m.quote |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+        m.backslash |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << shift;
+        m.op |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(op))) << shift;
+        m.whitespace |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(ws))) << shift;
+    }
+    return m;
+}
+
+__attribute__((target("avx2")))
+BlockMasks classifyAvx2(const unsigned char* p) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i lowerBit = _mm256_set1_epi8(0x20);
+    const __m256i openBrace = _mm256_set1_epi8('{');
+    const __m256i closeBrace = _mm256_set1_epi8('}');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+
+    BlockMasks m{0, 0, 0, 0};
+    for (int k = 0; k < 2; ++k) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * k));
+        __m256i folded = _mm256_or_si256(v, lowerBit);
+        __m256i op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, openBrace), _mm256_cmpeq_epi8(folded, closeBrace)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, comma), _mm256_cmpeq_epi8(v, colon)));
+        __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, newline), _mm256_cmpeq_epi8(v, cr)));
+        int shift = 32 * k;
+        m.quote |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << shift;
+        m.backslash |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)))) << shift;
+        m.op |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(op))) << shift;
+        m.whitespace |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(ws))) << shift;
+    }
+    return m;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+BlockMasks classifyAvx512(const unsigned char* p) {
+    __m512i v = _mm512_loadu_si512(p);
+    __m512i folded = _mm512_or_si512(v, _mm512_set1_epi8(0x20));
+    BlockMasks m;
+    m.quote = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('"'));
+    m.backslash = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\\'));
+    m.op = _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('{')) |
+           _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('}')) |
+           _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(',')) |
+           _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(':'));
+    m.whitespace = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(' ')) |
+                   _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\t')) |
+                   _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\n')) |
+                   _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\r'));
+    return m;
+}
+
+// 字符串扫描内核：查找引号、反斜杠或控制字符
+__attribute__((target("sse2")))
+size_t findStringSpecialSse2(const char* data, size_t size) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i controlMax = _mm_set1_epi8(0x1F);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(v, controlMax), v));
+        int mask = _mm_movemask_epi8(special);
+        if (mask) {
+            return i + static_cast<size_t>(countTrailingZeros(static_cast<uint64_t>(mask)));
+        }
+    }
+    return i + findStringSpecialScalar(data + i, size - i);
+}
+
+// UTF-8 校验内核：整块为ASCII时直接跳过
+__attribute__((target("sse2")))
+size_t validateUtf8Sse2(const unsigned char* data, size_t size) {
+    size_t i = 0;
+    while (i + 16 <= size) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        if (!mask) {
+            i += 16;
+            continue;
+        }
+        i = validateNonAscii(data, size, i + static_cast<size_t>(countTrailingZeros(static_cast<uint64_t>(mask))));
+        if (i & kUtf8Error) {
+            return i;
+        }
+    }
+    while (i < size) {
+        i = data[i] & 0x80 ? validateNonAscii(data, size, i) : i + 1;
+        if (i & kUtf8Error) {
+            return i;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+size_t validateUtf8Avx2(const unsigned char* data, size_t size) {
+    size_t i = 0;
+    while (i + 32 <= size) {
+        uint32_t mask = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))));
+        if (!mask) {
+            i += 32;
+            continue;
+        }
+        i = validateNonAscii(data, size, i + static_cast<size_t>(countTrailingZeros(mask)));
+        if (i & kUtf8Error) {
+            return i;
+        }
+    }
+    while (i < size) {
+        i = data[i] & 0x80 ? validateNonAscii(data, size, i) : i + 1;
+        if (i & kUtf8Error) {
+            return i;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+size_t validateUtf8Avx512(const unsigned char* data, size_t size) {
+    size_t i = 0;
+    while (i + 64 <= size) {
+        uint64_t mask = _mm512_movepi8_mask(_mm512_loadu_si512(data + i));
+        if (!mask) {
+            i += 64;
+            continue;
+        }
+        i = validateNonAscii(data, size, i + static_cast<size_t>(countTrailingZeros(mask)));
+        if (i & kUtf8Error) {
+            return i;
+        }
+    }
+    while (i < size) {
+        i = data[i] & 0x80 ? validateNonAscii(data, size, i) : i + 1;
+        if (i & kUtf8Error) {
+            return i;
+        }
+    }
+    return i;
+}
+
+#endif // JSON_STRUCTURAL_X86
+
+SimdLevel resolveLevel(SimdLevel requested) {
+    SimdLevel best = detectSimdLevel();
+    if (requested == SimdLevel::Auto || static_cast<int>(requested) > static_cast<int>(best)) {
+        return best;
+    }
+    return requested;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef JSON_STRUCTURAL_X86
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw")) return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+size_t findStringSpecial(const char* data, size_t size) {
+#ifdef JSON_STRUCTURAL_X86
+    // 只用SSE2：字符串通常很短，进入VEX/EVEX代码的固定开销会超过更宽向量的收益
+    static const bool useSse2 = detectSimdLevel() != SimdLevel::Scalar;
+    if (useSse2) {
+        return findStringSpecialSse2(data, size);
+    }
+#endif
+    return findStringSpecialScalar(data, size);
+}
+
+bool validateUtf8(std::string_view input, size_t* errorOffset) {
+    // 整个输入只调用一次内核
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(input.data());
+    size_t result;
+    switch (resolveLevel(SimdLevel::Auto)) {
+#ifdef JSON_STRUCTURAL_X86
+        case SimdLevel::AVX512: result = validateUtf8Avx512(data, input.size()); break;
+        case SimdLevel::AVX2: result = validateUtf8Avx2(data, input.size()); break;
+        case SimdLevel::SSE2: result = validateUtf8Sse2(data, input.size()); break;
+#endif
+        default: result = validateUtf8Scalar(data, input.size()); break;
+    }
+    if (result & kUtf8Error) {
+        if (errorOffset) {
+            *errorOffset = result & ~kUtf8Error;
+        }
+        return false;
+    }
+    return true;
+}
+
+void StructuralIndex::build(std::string_view input, SimdLevel level) {
+    positions_.clear();
+    level_ = resolveLevel(level);
+    switch (level_) {
+#ifdef JSON_STRUCTURAL_X86
+        case SimdLevel::AVX512:
+            unclosedString_ = scanBlocks(input, positions_, classifyAvx512);
+            break;
+        case SimdLevel::AVX2:
+            unclosedString_ = scanBlocks(input, positions_, classifyAvx2);
+            break;
+        case SimdLevel::SSE2:
+            unclosedString_ = scanBlocks(input, positions_, classifySse2);
+            break;
+#endif
+        default:
+            level_ = SimdLevel::Scalar;
+            unclosedString_ = scanScalar(input, positions_);
+            break;
+    }
+}
+
+} // namespace json
@@ -0,0 +1,151 @@
+#include "json_thread_pool.h"
+#include <algorithm>
+#include <exception>
+
+namespace json {
+
+namespace {
+
+// 当前线程所属的线程池及其工作线程编号
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    queues_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    workAvailable_.notify_all();
+    // 工作线程退出前会把队列中剩余的任务执行完
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    size_t index = currentPool == this ? currentWorker
+                                       : nextQueue_.fetch_add(1) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    queued_.fetch_add(1);
+    {
+        // 加锁后通知，避免与进入休眠的工作线程错过唤醒
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    workAvailable_.notify_one();
+}
+
+bool ThreadPool::takeTask(size_t preferred, Task& task) {
+    if (queued_.load() == 0) {
+        return false;
+    }
+    // 先从自己的队列尾部取
+    {
+        Queue& own = *queues_[preferred];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued_.fetch_sub(1);
+            return true;
+        }
+    }
+    // 再从其他队列头部窃取
+    for (size_t i = 1; i < queues_.size(); ++i) {
+        Queue& victim = *queues_[(preferred + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runOne(size_t preferred) {
+    Task task;
+    if (!takeTask(preferred, task)) {
+        return false;
+    }
+    task();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    taskFinished_.notify_all();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        if (runOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        workAvailable_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+        if (stop_ && queued_.load() == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    std::atomic<size_t> remaining{count};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    for (size_t i = 0; i < count; ++i) {
+        submit([&, i] {
+            try {
+                body(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            remaining.fetch_sub(1);
+        });
+    }
+
+    // 等待期间帮忙执行任务
+    size_t preferred = currentPool == this ? currentWorker : 0;
+    while (remaining.load() > 0) {
+        if (runOne(preferred)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        taskFinished_.wait(lock, [&] { return remaining.load() == 0 || queued_.load() > 0; });
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace json
@@ -0,0 +1,205 @@
+#include "json_validate.h"
+#include "json_grammar.h"
+#include "json_lexer.h"
+#include "json_number.h"
+#include "json_structural.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace json {
+
+namespace {
+
+// 词法错误的种类对应的错误码
+ValidationError lexerError(LexErrorKind kind) {
+    switch (kind) {
+        case LexErrorKind::UnexpectedCharacter: return ValidationError::UnexpectedCharacter;
+        case LexErrorKind::InvalidLiteral: return ValidationError::InvalidLiteral;
+        case LexErrorKind::InvalidEscape: return ValidationError::InvalidEscape;
+        case LexErrorKind::ControlCharacter: return ValidationError::ControlCharacter;
+        case LexErrorKind::UnterminatedString: return ValidationError::UnterminatedString;
+        case LexErrorKind::InvalidNumber:
+        case LexErrorKind::None: break;
+    }
+    return ValidationError::InvalidNumber;
+}
+
+ValidationError grammarError(GrammarError error) {
+    switch (error) {
+        case GrammarError::ExpectedValue: return ValidationError::ExpectedValue;
+        case GrammarError::ExpectedKey: return ValidationError::ExpectedKey;
+        case GrammarError::ExpectedColon: return ValidationError::ExpectedColon;
+        case GrammarError::ExpectedObjectEnd: return ValidationError::ExpectedObjectEnd;
+        case GrammarError::ExpectedArrayEnd: return ValidationError::ExpectedArrayEnd;
+        case GrammarError::ExpectedMemberEnd: break;
+    }
+    return ValidationError::TrailingContent;
+}
+
+// 只有带指数或极长的数字可能超出 double 的范围，其余无需转换
+bool numberInRange(std::string_view text) {
+    if (text.size() < 300 && text.find_first_of("eE") == std::string_view::npos) {
+        return true;
+    }
+    NumberValue number;
+    return tryParseNumber(text, number);
+}
+
+// 与 SaxReader 共用 detail::parseGrammar，去掉了事件、字符串解码和异常。
+// 每层容器只占 8 字节：最高位表示对象，其余位为已开始的成员数
+class Validator {
+public:
+    Validator(std::string_view input, const ValidateOptions& options)
+        : lexer_(input), options_(options) {}
+
+    ValidationResult run() {
+        if (advance() && detail::parseGrammar(*this, 0) && current_.type != TokenType::END_OF_FILE) {
+            fail(ValidationError::TrailingContent, current_.offset);
+        }
+        return result_;
+    }
+
+private:
+    template <typename Actions>
+    friend bool detail::parseGrammar(Actions& actions, size_t base);
+    template <typename Actions>
+    friend bool detail::parseMemberStart(Actions& actions);
+
+    static constexpr size_t kInlineDepth = kDefaultMaxDepth;
+    static constexpr uint64_t kObjectBit = uint64_t(1) << 63;
+
+    JsonLexer lexer_;
+    const ValidateOptions& options_;
+    Token current_;
+    ValidationResult result_;
+    uint64_t inline_[kInlineDepth];
+    std::unique_ptr<uint64_t[]> heap_;
+    uint64_t* frames_ = inline_;
+    size_t capacity_ = kInlineDepth;
+    size_t depth_ = 0;
+
+    bool fail(ValidationError error, size_t offset) {
+        result_.error = error;
+        result_.offset = offset;
+        return false;
+    }
+
+    // 语法动作（见 detail::parseGrammar）
+    const Token& token() const { return current_; }
+    size_t depth() const { return depth_; }
+    bool topIsObject() const { return frames_[depth_ - 1] & kObjectBit; }
+
+    bool advance() {
+        current_ = lexer_.nextToken();
+        if (current_.type == TokenType::ERROR) {
+            return fail(lexerError(current_.error), current_.offset);
+        }
+        return true;
+    }
+
+    bool fail(GrammarError error) { return fail(grammarError(error), current_.offset); }
+
+    bool startContainer(bool) {
+        if (depth_ >= options_.maxDepth) {
+            return fail(ValidationError::TooDeep, current_.offset);
+        }
+        return true;
+    }
+
+    bool push(bool isObject) {
+        if (depth_ == capacity_) {
+            // 超过内联容量（仅当 maxDepth 大于默认值）时按倍数扩展到堆上
+            size_t capacity = std::min(options_.maxDepth, capacity_ * 2);
+            std::unique_ptr<uint64_t[]> frames(new (std::nothrow) uint64_t[capacity]);
+            if (!frames) {
+                return fail(ValidationError::TooDeep, current_.offset);
+            }
+            std::memcpy(frames.get(), frames_, depth_ * sizeof(uint64_t));
+            heap_ = std::move(frames);
+            frames_ = heap_.get();
+            capacity_ = capacity;
+        }
+        frames_[depth_++] = isObject ? kObjectBit : 0;
+        return true;
+    }
+
+    size_t pop() { return frames_[--depth_] & ~kObjectBit; }
+    bool endContainer(bool, size_t) { return true; }
+
+    // 当前容器又开始一个成员
+    bool member() {
+        uint64_t& top = frames_[depth_ - 1];
+        if ((top & ~kObjectBit) >= options_.maxMembers) {
+            return fail(ValidationError::TooManyMembers, current_.offset);
+        }
+        top++;
+        return true;
+    }
+
+    // 当前词法单元是字符串；检查长度后跳过
+    bool string() {
+        if (current_.value.size() > options_.maxStringLength) {
+            return fail(ValidationError::StringTooLong, current_.offset);
+        }
+        return advance();
+    }
+
+    bool key() { return string(); }
+
+    bool number() {
+        if (!numberInRange(current_.value)) {
+            return fail(ValidationError::NumberOutOfRange, current_.offset);
+        }
+        return advance();
+    }
+
+    bool boolean(bool) { return advance(); }
+    bool null() { return advance(); }
+};
+
+} // namespace
+
+const char* validationMessage(ValidationError error) {
+    switch (error) {
+        case ValidationError::None: return "No error";
+        case ValidationError::UnexpectedCharacter: return "Unexpected character";
+        case ValidationError::InvalidLiteral: return "Invalid identifier";
+        case ValidationError::InvalidNumber: return "Invalid number";
+        case ValidationError::NumberOutOfRange: return "Number out of range";
+        case ValidationError::InvalidEscape: return "Invalid escape sequence";
+        case ValidationError::ControlCharacter: return "Invalid control character in string";
+        case ValidationError::UnterminatedString: return "Unterminated string";
+        case ValidationError::InvalidUtf8: return "Invalid UTF-8";
+        case ValidationError::ExpectedValue: return "Expected a value";
+        case ValidationError::ExpectedKey: return "Expected string key";
+        case ValidationError::ExpectedColon: return "Expected ':' after key";
+        case ValidationError::ExpectedObjectEnd: return "Expected '}' after object";
+        case ValidationError::ExpectedArrayEnd: return "Expected ']' after array";
+        case ValidationError::TrailingContent: return "Expected end of file";
+        case ValidationError::TooLarge: return "Input too large";
+        case ValidationError::TooDeep: return "Maximum nesting depth exceeded";
+        case ValidationError::StringTooLong: return "String too long";
+        default: return "Too many members";
+    }
+}
+
+ValidationResult validate(std::string_view input, const ValidateOptions& options) noexcept {
+    ValidationResult result;
+    if (input.size() > options.maxSize) {
+        result.error = ValidationError::TooLarge;
+        result.offset = options.maxSize;
+        return result;
+    }
+    size_t offset = 0;
+    if (options.validateUtf8 && !validateUtf8(input, &offset)) {
+        result.error = ValidationError::InvalidUtf8;
+        result.offset = offset;
+        return result;
+    }
+    // 顺序扫描模式不建结构索引，整个过程不分配内存
+    return Validator(input, options).run();
+}
+
+} // namespace json
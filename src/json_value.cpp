@@ -1,95 +1,343 @@
 #include "json_value.h"
-#include <sstream>
-#include <iomanip>
+#include "json_number.h"
+#include "json_writer.h"
+#include <stdexcept>
+#include <limits>
 
 namespace json {
 
-std::string JsonValue::toString() const {
-    if (isNull()) {
-        return "null";
-    }
-    
-    if (isBoolean()) {
-        return asBoolean() ? "true" : "false";
-    }
-    
-    if (isNumber()) {
-        std::stringstream ss;
-        ss << std::fixed << std::setprecision(6) << asNumber();
-        std::string str = ss.str();
-        
-        // Remove trailing zeros
-        str.erase(str.find_last_not_of('0') + 1, std::string::npos);
-        if (str.back() == '.') {
-            str.pop_back();
+// ---------------------------------------------------------------------------
+// JsonObject
+
+namespace {
+
+uint32_t hashTag(size_t hash) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(hash) >> 32);
+}
+
+} // namespace
+
+size_t JsonObject::hashKey(std::string_view key) {
+    return std::hash<std::string_view>{}(key);
+}
+
+void JsonObject::reserve(size_t count) {
+    members_.reserve(count);
+}
+
+void JsonObject::clear() {
+    members_.clear();
+    index_.clear();
+}
+
+JsonValue& JsonObject::at(std::string_view key) {
+    size_t i = findIndex(key);
+    if (i == npos) {
+        throw std::out_of_range("JsonObject::at");
+    }
+    return members_[i].second;
+}
+
+const JsonValue& JsonObject::at(std::string_view key) const {
+    size_t i = findIndex(key);
+    if (i == npos) {
+        throw std::out_of_range("JsonObject::at");
+    }
+    return members_[i].second;
+}
+
+JsonValue& JsonObject::operator[](std::string key) {
+    size_t hash = index_.empty() ? 0 : hashKey(key);
+    size_t i = findIndex(key, hash);
+    if (i == npos) {
+        i = append(std::move(key), JsonValue(), hash);
+    }
+    return members_[i].second;
+}
+
+std::pair<JsonObject::iterator, bool> JsonObject::emplace(std::string key, JsonValue value) {
+    size_t hash = index_.empty() ? 0 : hashKey(key);
+    size_t i = findIndex(key, hash);
+    if (i != npos) {
+        return {begin() + i, false};
+    }
+    i = append(std::move(key), std::move(value), hash);
+    return {begin() + i, true};
+}
+
+std::pair<JsonObject::iterator, bool> JsonObject::insert(value_type member) {
+    return emplace(std::move(member.first), std::move(member.second));
+}
+
+size_t JsonObject::erase(std::string_view key) {
+    size_t i = findIndex(key);
+    if (i == npos) {
+        return 0;
+    }
+    members_.erase(members_.begin() + static_cast<std::ptrdiff_t>(i));
+    rebuildIndex();
+    return 1;
+}
+
+size_t JsonObject::findIndex(std::string_view key) const {
+    return findIndex(key, index_.empty() ? 0 : hashKey(key));
+}
+
+size_t JsonObject::findIndex(std::string_view key, size_t hash) const {
+    if (index_.empty()) {
+        // 小对象线性查找，连续内存上比哈希更快
+        for (size_t i = 0; i < members_.size(); ++i) {
+            if (members_[i].first == key) {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    size_t mask = index_.size() - 1;
+    uint32_t tag = hashTag(hash);
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        uint64_t entry = index_[slot];
+        if (!entry) {
+            return npos;
+        }
+        if (static_cast<uint32_t>(entry >> 32) == tag) {
+            size_t i = static_cast<size_t>(entry & 0xFFFFFFFFu) - 1;
+            if (members_[i].first == key) {
+                return i;
+            }
+        }
+    }
+}
+
+size_t JsonObject::append(std::string&& key, JsonValue&& value, size_t hash) {
+    bool indexed = !index_.empty();
+    members_.emplace_back(std::move(key), std::move(value));
+    size_t position = members_.size() - 1;
+    if (members_.size() > kIndexThreshold) {
+        // 负载因子保持在1/2以下
+        if (!indexed || members_.size() * 2 > index_.size()) {
+            rebuildIndex();
+        } else {
+            indexInsert(position, hash);
+        }
+    }
+    return position;
+}
+
+void JsonObject::indexInsert(size_t position, size_t hash) {
+    size_t mask = index_.size() - 1;
+    size_t slot = hash & mask;
+    while (index_[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    index_[slot] = (static_cast<uint64_t>(hashTag(hash)) << 32) | static_cast<uint64_t>(position + 1);
+}
+
+void JsonObject::rebuildIndex() {
+    index_.clear();
+    if (members_.size() <= kIndexThreshold) {
+        return;
+    }
+    size_t capacity = 64;
+    while (capacity < members_.size() * 4) {
+        capacity <<= 1;
+    }
+    index_.assign(capacity, 0);
+    for (size_t i = 0; i < members_.size(); ++i) {
+        indexInsert(i, hashKey(members_[i].first));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// JsonValue
+
+JsonValue::~JsonValue() {
+    // 只有嵌套容器时才需要工作表；叶子和扁平容器直接交给 variant 析构
+    if (!hasNestedContainers()) {
+        return;
+    }
+    std::vector<JsonValue> pending;
+    detachNestedContainers(pending);
+    while (!pending.empty()) {
+        JsonValue value = std::move(pending.back());
+        pending.pop_back();
+        // 先摘下子容器，value 离开作用域时只剩浅层内容
+        value.detachNestedContainers(pending);
+    }
+}
+
+bool JsonValue::isNonEmptyContainer() const {
+    if (const Array* array = std::get_if<Array>(&value_)) {
+        return !array->empty();
+    }
+    if (const Object* object = std::get_if<Object>(&value_)) {
+        return !object->empty();
+    }
+    return false;
+}
+
+bool JsonValue::hasNestedContainers() const {
+    if (const Array* array = std::get_if<Array>(&value_)) {
+        for (const JsonValue& element : *array) {
+            if (element.isNonEmptyContainer()) {
+                return true;
+            }
+        }
+    } else if (const Object* object = std::get_if<Object>(&value_)) {
+        for (const auto& member : *object) {
+            if (member.second.isNonEmptyContainer()) {
+                return true;
+            }
         }
-        
-        return str;
-    }
-    
-    if (isString()) {
-        std::stringstream ss;
-        ss << '"';
-        
-        for (char c : asString()) {
-            switch (c) {
-                case '"': ss << "\\\""; break;
-                case '\\': ss << "\\\\"; break;
-                case '/': ss << "\\/"; break;
-                case '\b': ss << "\\b"; break;
-                case '\f': ss << "\\f"; break;
-                case '\n': ss << "\\n"; break;
-                case '\r': ss << "\\r"; break;
-                case '\t': ss << "\\t"; break;
-                default:
-                    if (c < 32 || c > 126) {
-                        // Handle non-ASCII characters
-                        ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
-                    } else {
-                        ss << c;
-                    }
+    }
+    return false;
+}
+
+void JsonValue::detachNestedContainers(std::vector<JsonValue>& pending) {
+    // 移出后的容器为空，析构时不会再向下递归
+    if (Array* array = std::get_if<Array>(&value_)) {
+        for (JsonValue& element : *array) {
+            if (element.isNonEmptyContainer()) {
+                pending.push_back(std::move(element));
             }
         }
-        
-        ss << '"';
-        return ss.str();
-    }
-    
-    if (isArray()) {
-        std::stringstream ss;
-        ss << '[';
-        
-        const auto& array = asArray();
-        for (size_t i = 0; i < array.size(); ++i) {
-            if (i > 0) {
-                ss << ',';
+    } else if (Object* object = std::get_if<Object>(&value_)) {
+        for (auto& member : *object) {
+            if (member.second.isNonEmptyContainer()) {
+                pending.push_back(std::move(member.second));
             }
-            ss << array[i].toString();
         }
-        
-        ss << ']';
-        return ss.str();
-    }
-    
-    if (isObject()) {
-        std::stringstream ss;
-        ss << '{';
-        
-        const auto& object = asObject();
-        size_t i = 0;
-        for (const auto& [key, value] : object) {
-            if (i > 0) {
-                ss << ',';
+    }
+}
+
+JsonValue::Number JsonValue::asNumber() const {
+    if (const Integer* i = std::get_if<Integer>(&value_)) {
+        return static_cast<Number>(*i);
+    }
+    if (const Unsigned* u = std::get_if<Unsigned>(&value_)) {
+        return static_cast<Number>(*u);
+    }
+    return std::get<Number>(value_);
+}
+
+JsonValue::Integer JsonValue::asInt64() const {
+    if (const Unsigned* u = std::get_if<Unsigned>(&value_)) {
+        if (*u > static_cast<Unsigned>(std::numeric_limits<Integer>::max())) {
+            throw std::out_of_range("JsonValue::asInt64");
+        }
+        return static_cast<Integer>(*u);
+    }
+    return std::get<Integer>(value_);
+}
+
+JsonValue::Unsigned JsonValue::asUint64() const {
+    if (const Integer* i = std::get_if<Integer>(&value_)) {
+        if (*i < 0) {
+            throw std::out_of_range("JsonValue::asUint64");
+        }
+        return static_cast<Unsigned>(*i);
+    }
+    return std::get<Unsigned>(value_);
+}
+
+namespace {
+
+NumberValue numberOf(const JsonValue& value) {
+    NumberValue number;
+    value.visit([&number](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, JsonValue::Integer>) {
+            number.i = v;
+        } else if constexpr (std::is_same_v<T, JsonValue::Unsigned>) {
+            number.kind = NumberValue::Kind::UInt64;
+            number.u = v;
+        } else if constexpr (std::is_same_v<T, JsonValue::Number>) {
+            number.kind = NumberValue::Kind::Double;
+            number.d = v;
+        }
+    });
+    return number;
+}
+
+enum class Shallow { Different, Same, Descend };
+
+// 只比较值本身；类型和大小相同的非空容器交给调用方逐个比较子值
+Shallow compareShallow(const JsonValue& a, const JsonValue& b) {
+    if (a.isNumber() && b.isNumber()) {
+        return sameNumber(numberOf(a), numberOf(b)) ? Shallow::Same : Shallow::Different;
+    }
+    if (a.isString() && b.isString()) {
+        return a.asString() == b.asString() ? Shallow::Same : Shallow::Different;
+    }
+    if (a.isBoolean() && b.isBoolean()) {
+        return a.asBoolean() == b.asBoolean() ? Shallow::Same : Shallow::Different;
+    }
+    if (a.isNull() && b.isNull()) {
+        return Shallow::Same;
+    }
+    size_t size = 0;
+    if (a.isArray() && b.isArray()) {
+        size = a.asArray().size();
+        if (size != b.asArray().size()) {
+            return Shallow::Different;
+        }
+    } else if (a.isObject() && b.isObject()) {
+        size = a.asObject().size();
+        if (size != b.asObject().size()) {
+            return Shallow::Different;
+        }
+    } else {
+        return Shallow::Different;
+    }
+    return size == 0 ? Shallow::Same : Shallow::Descend;
+}
+
+} // namespace
+
+bool JsonValue::operator==(const JsonValue& other) const {
+    Shallow root = compareShallow(*this, other);
+    if (root != Shallow::Descend) {
+        return root == Shallow::Same;
+    }
+    // 标量子值当场比较，子容器入栈；一发现不同就返回
+    std::vector<std::pair<const JsonValue*, const JsonValue*>> pending{{this, &other}};
+    while (!pending.empty()) {
+        auto [a, b] = pending.back();
+        pending.pop_back();
+        auto visitChild = [&pending](const JsonValue& x, const JsonValue& y) {
+            Shallow result = compareShallow(x, y);
+            if (result == Shallow::Descend && &x != &y) {
+                pending.emplace_back(&x, &y);
+            }
+            return result != Shallow::Different;
+        };
+        if (a->isArray()) {
+            const Array& x = a->asArray();
+            const Array& y = b->asArray();
+            for (size_t i = 0; i < x.size(); ++i) {
+                if (!visitChild(x[i], y[i])) {
+                    return false;
+                }
+            }
+        } else {
+            const Object& y = b->asObject();
+            for (const auto& member : a->asObject()) {
+                auto it = y.find(member.first);
+                if (it == y.end() || !visitChild(member.second, it->second)) {
+                    return false;
+                }
             }
-            ss << '"' << key << "\":" << value.toString();
-            ++i;
         }
-        
-        ss << '}';
-        return ss.str();
     }
-    
-    return "null"; // Should not reach here
+    return true;
+}
+
+std::string JsonValue::toString() const {
+    std::string out;
+    JsonWriter writer(out);
+    writer.write(*this);
+    return out;
 }
 
-} // namespace json 
\ No newline at end of file
+} // namespace json
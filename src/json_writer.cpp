@@ -0,0 +1,343 @@
+#include "json_writer.h"
+#include "json_number.h"
+#include "json_structural.h"
+#include <algorithm>
+#include <cerrno>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace json {
+
+namespace {
+
+// 转义表：覆盖 findStringSpecial 会停下的字节（引号、反斜杠、控制字符），
+// 其余字节（包括UTF-8多字节序列）原样输出；'u' 表示 \u00XX
+struct EscapeTable {
+    char codes[256];
+
+    EscapeTable() : codes() {
+        for (int c = 0; c < 0x20; ++c) {
+            codes[c] = 'u';
+        }
+        codes[static_cast<unsigned char>('"')] = '"';
+        codes[static_cast<unsigned char>('\\')] = '\\';
+        codes[static_cast<unsigned char>('\b')] = 'b';
+        codes[static_cast<unsigned char>('\f')] = 'f';
+        codes[static_cast<unsigned char>('\n')] = 'n';
+        codes[static_cast<unsigned char>('\r')] = 'r';
+        codes[static_cast<unsigned char>('\t')] = 't';
+    }
+};
+
+const EscapeTable kEscapes;
+
+const char kHexDigits[] = "0123456789abcdef";
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Sinks
+
+bool FileSink::write(const char* data, size_t size) {
+    return std::fwrite(data, 1, size, file_) == size;
+}
+
+bool FdSink::write(const char* data, size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+        int n = ::_write(fd_, data, static_cast<unsigned int>(size));
+#else
+        ssize_t n = ::write(fd_, data, size);
+#endif
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// JsonWriter
+
+JsonWriter::JsonWriter(std::string& out, const WriterOptions& options)
+    : target_(&out), sink_(nullptr), bufferSize_(0), options_(options),
+      afterKey_(false), hasRoot_(false) {}
+
+JsonWriter::JsonWriter(OutputSink& sink, const WriterOptions& options, size_t bufferSize)
+    : target_(&buffer_), sink_(&sink), bufferSize_(bufferSize ? bufferSize : 1), options_(options),
+      afterKey_(false), hasRoot_(false) {
+    buffer_.reserve(bufferSize_ + kMaxNumberLength);
+}
+
+JsonWriter::~JsonWriter() {
+    try {
+        flush();
+    } catch (const WriterError&) {
+        // 析构时无法报告错误；需要错误信息的调用方应显式调用 flush()
+    }
+}
+
+void JsonWriter::flush() {
+    if (!sink_ || buffer_.empty()) {
+        return;
+    }
+    // 缓冲区可能略超出 bufferSize_（最后一个词法单元整体写入），按块交给 sink
+    bool accepted = true;
+    for (size_t offset = 0; accepted && offset < buffer_.size(); offset += bufferSize_) {
+        accepted = sink_->write(buffer_.data() + offset, std::min(bufferSize_, buffer_.size() - offset));
+    }
+    buffer_.clear();
+    if (!accepted) {
+        throw WriterError("Output sink rejected data");
+    }
+}
+
+void JsonWriter::putRun(const char* data, size_t size) {
+    // 长片段先填满缓冲区再写出，不会整段复制进缓冲区
+    while (sink_ && buffer_.size() + size > bufferSize_) {
+        size_t room = bufferSize_ - std::min(buffer_.size(), bufferSize_);
+        put(data, room);
+        data += room;
+        size -= room;
+        flush();
+    }
+    put(data, size);
+}
+
+void JsonWriter::newline(size_t depth) {
+    put('\n');
+    size_t spaces = depth * static_cast<size_t>(options_.indent);
+    target_->append(spaces, ' ');
+}
+
+void JsonWriter::beforeValue() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (stack_.empty()) {
+        if (hasRoot_) {
+            put('\n');
+        }
+        hasRoot_ = true;
+        return;
+    }
+    Frame& top = stack_.back();
+    if (top.isObject) {
+        throw WriterError("Expected key inside object");
+    }
+    if (top.count++ > 0) {
+        put(',');
+    }
+    if (options_.pretty) {
+        newline(stack_.size());
+    }
+}
+
+void JsonWriter::beginObject() {
+    beforeValue();
+    put('{');
+    stack_.push_back(Frame{true, 0});
+}
+
+void JsonWriter::endObject() {
+    if (stack_.empty() || !stack_.back().isObject || afterKey_) {
+        throw WriterError("Mismatched endObject");
+    }
+    bool empty = stack_.back().count == 0;
+    stack_.pop_back();
+    if (options_.pretty && !empty) {
+        newline(stack_.size());
+    }
+    put('}');
+    maybeFlush();
+}
+
+void JsonWriter::beginArray() {
+    beforeValue();
+    put('[');
+    stack_.push_back(Frame{false, 0});
+}
+
+void JsonWriter::endArray() {
+    if (stack_.empty() || stack_.back().isObject) {
+        throw WriterError("Mismatched endArray");
+    }
+    bool empty = stack_.back().count == 0;
+    stack_.pop_back();
+    if (options_.pretty && !empty) {
+        newline(stack_.size());
+    }
+    put(']');
+    maybeFlush();
+}
+
+void JsonWriter::key(std::string_view name) {
+    if (stack_.empty() || !stack_.back().isObject || afterKey_) {
+        throw WriterError("Key outside object");
+    }
+    Frame& top = stack_.back();
+    if (top.count++ > 0) {
+        put(',');
+    }
+    if (options_.pretty) {
+        newline(stack_.size());
+    }
+    writeEscaped(name);
+    if (options_.pretty) {
+        put(": ", 2);
+    } else {
+        put(':');
+    }
+    afterKey_ = true;
+}
+
+void JsonWriter::string(std::string_view str) {
+    beforeValue();
+    writeEscaped(str);
+    maybeFlush();
+}
+
+void JsonWriter::number(double num) {
+    beforeValue();
+    char buffer[kMaxNumberLength];
+    put(buffer, formatNumber(num, buffer));
+    maybeFlush();
+}
+
+void JsonWriter::integer(int64_t num) {
+    beforeValue();
+    char buffer[kMaxNumberLength];
+    put(buffer, formatNumber(num, buffer));
+    maybeFlush();
+}
+
+void JsonWriter::unsignedInteger(uint64_t num) {
+    beforeValue();
+    char buffer[kMaxNumberLength];
+    put(buffer, formatNumber(num, buffer));
+    maybeFlush();
+}
+
+void JsonWriter::boolean(bool b) {
+    beforeValue();
+    if (b) {
+        put("true", 4);
+    } else {
+        put("false", 5);
+    }
+    maybeFlush();
+}
+
+void JsonWriter::null() {
+    beforeValue();
+    put("null", 4);
+    maybeFlush();
+}
+
+void JsonWriter::writeEscaped(std::string_view str) {
+    put('"');
+    const char* data = str.data();
+    size_t size = str.size();
+    size_t runStart = 0;
+    while (runStart < size) {
+        // 向量化查找下一个需要转义的字节，之前的部分整段复制
+        size_t i = runStart + findStringSpecial(data + runStart, size - runStart);
+        putRun(data + runStart, i - runStart);
+        if (i == size) {
+            break;
+        }
+        char code = kEscapes.codes[static_cast<unsigned char>(data[i])];
+        runStart = i + 1;
+        if (code == 'u') {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            char escape[6] = {'\\', 'u', '0', '0', kHexDigits[c >> 4], kHexDigits[c & 0xF]};
+            put(escape, 6);
+        } else {
+            char escape[2] = {'\\', code};
+            put(escape, 2);
+        }
+        if (sink_ && buffer_.size() >= bufferSize_) {
+            flush();
+        }
+    }
+    put('"');
+}
+
+void JsonWriter::write(const JsonValue& value) {
+    writeValue(value);
+    maybeFlush();
+}
+
+void JsonWriter::writeValue(const JsonValue& root) {
+    // 显式栈代替递归：记录每个打开的容器和下一个要写出的子节点
+    cursors_.clear();
+    const JsonValue* value = &root;
+    while (value) {
+        if (value->isObject()) {
+            beginObject();
+            cursors_.push_back(Cursor{value, 0});
+        } else if (value->isArray()) {
+            beginArray();
+            cursors_.push_back(Cursor{value, 0});
+        } else {
+            writeScalar(*value);
+        }
+
+        // 找到下一个要写出的值，途中关闭已写完的容器
+        value = nullptr;
+        while (!value && !cursors_.empty()) {
+            Cursor& top = cursors_.back();
+            if (top.container->isObject()) {
+                const JsonValue::Object& object = top.container->asObject();
+                if (top.next < object.size()) {
+                    const auto& member = object.begin()[top.next++];
+                    key(member.first);
+                    value = &member.second;
+                } else {
+                    cursors_.pop_back();
+                    endObject();
+                }
+            } else {
+                const JsonValue::Array& array = top.container->asArray();
+                if (top.next < array.size()) {
+                    value = &array[top.next++];
+                } else {
+                    cursors_.pop_back();
+                    endArray();
+                }
+            }
+        }
+    }
+}
+
+void JsonWriter::writeScalar(const JsonValue& value) {
+    value.visit([this](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, JsonValue::String>) {
+            string(v);
+        } else if constexpr (std::is_same_v<T, JsonValue::Number>) {
+            number(v);
+        } else if constexpr (std::is_same_v<T, JsonValue::Integer>) {
+            integer(v);
+        } else if constexpr (std::is_same_v<T, JsonValue::Unsigned>) {
+            unsignedInteger(v);
+        } else if constexpr (std::is_same_v<T, JsonValue::Boolean>) {
+            boolean(v);
+        } else if constexpr (std::is_same_v<T, JsonValue::Null>) {
+            null();
+        }
+    });
+}
+
+} // namespace json
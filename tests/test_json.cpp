@@ -1,7 +1,91 @@
 #include "json_parser.h"
+#include "json_document.h"
+#include "json_stream.h"
+#include "json_sax.h"
+#include "json_ondemand.h"
+#include "json_number.h"
+#include "json_writer.h"
+#include "json_structural.h"
+#include "json_ndjson.h"
+#include "json_file.h"
+#include "json_query.h"
+#include "json_bind.h"
+#include "json_cbor.h"
+#include "json_parallel.h"
+#include "json_stats.h"
+#include "json_patch.h"
+#include "json_hash.h"
+#include "json_validate.h"
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// 统计堆分配次数，用于检查解析器复用后的稳态零分配
+std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// 绑定测试用的结构体，放在独立命名空间里以验证按参数查找
+namespace bound {
+
+struct Address {
+    std::string city;
+    std::string street;
+};
+JSON_BIND(Address, city, street)
+
+struct Person {
+    std::string name;
+    int age = 0;
+    double score = 0;
+    bool active = false;
+    uint8_t level = 0;
+    std::optional<std::string> nickname;
+    std::vector<std::string> hobbies;
+    Address address;
+    std::vector<Address> previous;
+    json::JsonValue extra;
+};
+JSON_BIND(Person, name, age, score, active, level, nickname, hobbies, address, previous, extra)
+
+struct Renamed {
+    int64_t id = 0;
+    std::string firstName;
+};
+
+constexpr auto jsonBinding(const Renamed*) {
+    return std::make_tuple(json::field("ID", &Renamed::id), json::field("first_name", &Renamed::firstName));
+}
+
+} // namespace bound
 
 // 浮点数比较的辅助函数
 bool isClose(double a, double b, double epsilon = 1e-6) {
@@ -41,6 +125,86 @@ void testBasicTypes() {
     }
 }
 
+void testNumbers() {
+    // 64位整数精确保存
+    {
+        json::JsonParser parser("[9007199254740993, -9223372036854775808, 18446744073709551615, 42, -0, 1.5e3]");
+        auto value = parser.parse();
+        const auto& array = value.asArray();
+        assert(array[0].isInt());
+        assert(array[0].asInt64() == 9007199254740993LL);
+        assert(array[1].asInt64() == INT64_MIN);
+        assert(array[2].asUint64() == UINT64_MAX);
+        assert(array[3].isInt() && array[3].isNumber());
+        assert(isClose(array[3].asNumber(), 42.0));
+        assert(!array[4].isInt() && std::signbit(array[4].asNumber()));
+        assert(array[5].isDouble());
+        assert(isClose(array[5].asNumber(), 1500.0));
+        assert(value.toString() == "[9007199254740993,-9223372036854775808,18446744073709551615,42,-0,1500]");
+
+        bool threw = false;
+        try {
+            array[2].asInt64();
+        } catch (const std::out_of_range&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // 最短往返序列化
+    {
+        const double values[] = {1e-9, 0.1, 1e300, -123.456, 3.141592653589793, 5e-324, 1e21};
+        const char* expected[] = {"1e-09", "0.1", "1e+300", "-123.456", "3.141592653589793", "5e-324", "1e+21"};
+        for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+            std::string text = json::JsonValue(values[i]).toString();
+            assert(text == expected[i]);
+            assert(json::JsonParser(text).parse().asNumber() == values[i]);
+        }
+        assert(json::JsonValue(std::nan("")).toString() == "null");
+    }
+
+    // 超出64位的整数退化为double
+    {
+        json::JsonParser parser("123456789012345678901234567890");
+        auto value = parser.parse();
+        assert(value.isDouble());
+        assert(isClose(value.asNumber() / 1.2345678901234568e29, 1.0));
+    }
+
+    // 快速路径与from_chars结果逐位一致
+    {
+        const char* inputs[] = {
+            "0.1", "3.141592653589793", "-2.5e-3", "1e22", "1e23", "123456789.123456789",
+            "2.2250738585072014e-308", "1.7976931348623157e308", "4.9e-324", "0.30000000000000004"
+        };
+        for (const char* input : inputs) {
+            json::NumberValue number = json::parseNumber(input);
+            assert(number.kind == json::NumberValue::Kind::Double);
+            assert(number.d == std::strtod(input, nullptr));
+        }
+    }
+
+    // 超出double范围
+    {
+        bool threw = false;
+        try {
+            json::JsonParser("1e400").parse();
+        } catch (const json::ParserError&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // 其他文档类型同样保存整数
+    {
+        auto doc = json::Document::parse("[12345678901234567]");
+        assert(doc.root().asArray()[0].asInt64() == 12345678901234567LL);
+        json::LazyDocument lazy("[12345678901234567, 2.5]");
+        assert(lazy[0].isInt() && lazy[0].asInt64() == 12345678901234567LL);
+        assert(!lazy[1].isInt());
+    }
+}
+
 void testArrays() {
     // 测试空数组
     {
@@ -110,6 +274,54 @@ void testObjects() {
     }
 }
 
+void testObjectOrder() {
+    // 序列化保持原始键顺序
+    {
+        const std::string input = R"({"zeta":1,"alpha":[true,null],"mid":{"b":"x","a":"y"}})";
+        json::JsonParser parser(input);
+        auto value = parser.parse();
+        assert(value.toString() == input);
+    }
+
+    // 重复键：保留第一次出现的位置，值取最后一次
+    {
+        json::JsonParser parser(R"({"a": 1, "b": 2, "a": 3})");
+        auto value = parser.parse();
+        const auto& object = value.asObject();
+        assert(object.size() == 2);
+        assert(isClose(object.at("a").asNumber(), 3.0));
+        assert(object.begin()->first == "a");
+    }
+
+    // 超过阈值后使用哈希索引
+    {
+        json::JsonObject object;
+        const size_t count = 10000;
+        for (size_t i = 0; i < count; ++i) {
+            object["key" + std::to_string(i)] = json::JsonValue(static_cast<double>(i));
+        }
+        assert(object.size() == count);
+        for (size_t i = 0; i < count; i += 97) {
+            assert(isClose(object.at("key" + std::to_string(i)).asNumber(), static_cast<double>(i)));
+        }
+        assert(object.find("missing") == object.end());
+        assert(!object.emplace("key5", json::JsonValue(true)).second);
+
+        assert(object.erase("key5") == 1);
+        assert(!object.contains("key5"));
+        assert(object.contains("key6"));
+        assert((object.begin() + 5)->first == "key6");
+
+        bool threw = false;
+        try {
+            object.at("key5");
+        } catch (const std::out_of_range&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+}
+
 void testStringEscaping() {
     // 测试转义字符
     {
@@ -128,6 +340,1825 @@ void testStringEscaping() {
     }
 }
 
+void testZeroCopyLexer() {
+    // 词法单元直接引用输入缓冲区
+    {
+        std::string input = R"({"key": "plain", "esc": "a\nb", "n": -12.5e3})";
+        json::JsonLexer lexer(input);
+        const char* begin = input.data();
+        const char* end = begin + input.size();
+
+        assert(lexer.nextToken().type == json::TokenType::LEFT_BRACE);
+        json::Token key = lexer.nextToken();
+        assert(key.type == json::TokenType::STRING);
+        assert(key.value == "key");
+        assert(key.value.data() >= begin && key.value.data() < end);
+        assert(!key.escaped);
+
+        lexer.nextToken(); // :
+        json::Token plain = lexer.nextToken();
+        assert(plain.value == "plain" && !plain.escaped);
+
+        lexer.nextToken(); // ,
+        lexer.nextToken(); // "esc"
+        lexer.nextToken(); // :
+        json::Token esc = lexer.nextToken();
+        assert(esc.escaped);
+        assert(esc.value == "a\\nb");
+        std::string decoded;
+        json::JsonLexer::unescape(esc.value, decoded);
+        assert(decoded == "a\nb");
+
+        lexer.nextToken(); // ,
+        lexer.nextToken(); // "n"
+        lexer.nextToken(); // :
+        json::Token number = lexer.nextToken();
+        assert(number.type == json::TokenType::NUMBER);
+        assert(number.value == "-12.5e3");
+        assert(number.value.data() >= begin && number.value.data() < end);
+    }
+
+    // 代理对解码为四字节UTF-8
+    {
+        json::JsonParser parser("\"\\ud83d\\ude00\"");
+        auto value = parser.parse();
+        assert(value.asString() == "\xF0\x9F\x98\x80");
+    }
+
+    // 非法的Unicode转义
+    {
+        bool threw = false;
+        try {
+            json::JsonParser parser("\"\\u12G4\"");
+            parser.parse();
+        } catch (const json::ParserError&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+}
+
+// 生成由JSON关键字符组成的随机输入，覆盖跨64字节块的转义与字符串
+std::string randomJsonish(std::mt19937& rng, size_t length) {
+    static const char alphabet[] = "\"\\{}[],: \n\tabn1-.e\"\"";
+    std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 2);
+    std::string s;
+    for (size_t i = 0; i < length; ++i) {
+        s += alphabet[pick(rng)];
+    }
+    return s;
+}
+
+void testStructuralIndex() {
+    const json::SimdLevel levels[] = {
+        json::SimdLevel::SSE2, json::SimdLevel::AVX2, json::SimdLevel::AVX512
+    };
+
+    // 各SIMD内核与标量实现的结构索引完全一致
+    {
+        std::mt19937 rng(42);
+        json::StructuralIndex expected;
+        json::StructuralIndex actual;
+        for (int round = 0; round < 2000; ++round) {
+            std::string input = randomJsonish(rng, round % 300);
+            expected.build(input, json::SimdLevel::Scalar);
+            for (json::SimdLevel level : levels) {
+                actual.build(input, level);
+                assert(actual.positions() == expected.positions());
+                assert(actual.unclosedString() == expected.unclosedString());
+            }
+        }
+    }
+
+    // 已知输入的索引内容
+    {
+        json::StructuralIndex index;
+        index.build(R"({"a\"b": [1, true]})");
+        const std::vector<uint32_t> expected = {0, 1, 6, 7, 9, 10, 11, 13, 17, 18};
+        assert(index.positions() == expected);
+        assert(!index.unclosedString());
+    }
+
+    // 索引模式与顺序模式产生相同的词法单元序列
+    {
+        std::mt19937 rng(7);
+        for (int round = 0; round < 2000; ++round) {
+            std::string input = randomJsonish(rng, round % 200);
+            json::JsonLexer sequential(input, json::ScanMode::Sequential);
+            json::JsonLexer indexed(input, json::ScanMode::Indexed);
+            while (true) {
+                json::Token a = sequential.nextToken();
+                json::Token b = indexed.nextToken();
+                assert(a.type == b.type);
+                assert(a.value == b.value);
+                assert(a.escaped == b.escaped);
+                assert(a.offset == b.offset);
+                if (a.type == json::TokenType::END_OF_FILE || a.type == json::TokenType::ERROR) {
+                    break;
+                }
+            }
+        }
+    }
+
+    // 行号和列号只在报错时计算
+    {
+        bool threw = false;
+        try {
+            json::JsonParser parser("{\n  \"a\": 1,\n  \"b\" 2\n}");
+            parser.parse();
+        } catch (const json::ParserError& e) {
+            threw = true;
+            assert(std::string(e.what()) == "Expected ':' after key at line 3, column 7");
+        }
+        assert(threw);
+    }
+}
+
+void testArenaDocument() {
+    // 紧凑的值表示
+    static_assert(sizeof(json::DocValue) == 16, "DocValue should be 16 bytes");
+
+    {
+        auto doc = json::Document::parse(R"({
+            "name": "John",
+            "age": 30,
+            "active": true,
+            "tags": ["a", "b\u0041"],
+            "address": {"city": "New York"},
+            "none": null
+        })");
+        const auto& root = doc.root();
+        assert(root.isObject());
+        auto object = root.asObject();
+        assert(object.size() == 6);
+        assert(object.at("name").asString() == "John");
+        assert(isClose(object.at("age").asNumber(), 30.0));
+        assert(object.at("active").asBoolean());
+        assert(object.at("none").isNull());
+        assert(object.at("address").asObject().at("city").asString() == "New York");
+
+        auto tags = object.at("tags").asArray();
+        assert(tags.size() == 2);
+        assert(tags[0].asString() == "a");
+        assert(tags[1].asString() == "bA");
+
+        // 成员保持文档顺序
+        const char* order[] = {"name", "age", "active", "tags", "address", "none"};
+        size_t i = 0;
+        for (const auto& [key, value] : object) {
+            assert(key == order[i++]);
+        }
+
+        assert(object.find("missing") == nullptr);
+        assert(doc.arena().bytesUsed() > 0);
+    }
+
+    // 重复的键保留全部成员，查找与 JsonValue 一样取最后一个
+    {
+        json::JsonParser parser;
+        json::Document doc;
+        parser.parse(R"({"a": 1, "b": 0, "a": 2})", doc);
+        auto object = doc.root().asObject();
+        assert(object.size() == 3);
+        assert(object.at("a").asInt64() == 2);
+        json::JsonValue value = parser.parse(R"({"a": 1, "b": 0, "a": 2})");
+        assert(object.find("a")->asInt64() == value.asObject().at("a").asInt64());
+        assert(object.count("a") == 1);
+    }
+
+    // 类型不匹配与JsonValue一样抛出异常
+    {
+        auto doc = json::Document::parse("[1, 2]");
+        bool threw = false;
+        try {
+            doc.root().asObject();
+        } catch (const std::bad_variant_access&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // 语法错误
+    {
+        bool threw = false;
+        try {
+            json::Document::parse("{\"a\" 1}");
+        } catch (const json::ParserError&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+}
+
+// 按固定大小分块喂给流式解析器
+json::JsonValue parseInChunks(const std::string& input, size_t chunkSize) {
+    json::StreamingParser parser;
+    for (size_t i = 0; i < input.size(); i += chunkSize) {
+        parser.feed(std::string_view(input).substr(i, chunkSize));
+    }
+    return parser.finish();
+}
+
+std::string errorOf(const std::function<void()>& parse) {
+    try {
+        parse();
+    } catch (const json::ParserError& e) {
+        return e.what();
+    }
+    return "";
+}
+
+void testStreamingParser() {
+    // 任意分块方式的结果都与整体解析一致
+    {
+        const std::string input = R"({"name": "Zhang \"San\"", "id": -12345.678e-2,
+            "unicode": "\u4e2d\u6587 \ud83d\ude00", "flags": [true, false, null],
+            "nested": {"deep": [[1, 2], {"x": "y"}], "empty": {}, "list": []}})";
+        json::JsonParser parser(input);
+        const std::string expected = parser.parse().toString();
+        for (size_t chunkSize = 1; chunkSize <= input.size(); ++chunkSize) {
+            assert(parseInChunks(input, chunkSize).toString() == expected);
+        }
+    }
+
+    // 标量根值在finish时才结束
+    {
+        json::StreamingParser parser;
+        parser.feed("12");
+        parser.feed("34");
+        auto value = parser.finish();
+        assert(isClose(value.asNumber(), 1234.0));
+
+        // finish之后可以复用
+        parser.feed("[tr");
+        parser.feed("ue]");
+        value = parser.finish();
+        assert(value.asArray()[0].asBoolean());
+    }
+
+    // 错误信息与JsonParser相同
+    {
+        const char* inputs[] = {
+            "[1, 2", "{\"a\" 1}", "{\"a\": 1,}", "[1 2]", "tru", "[1.]",
+            "\"abc", "\"\\x\"", "{\n  \"a\": nul\n}", "1 2", "[-]", ""
+        };
+        for (const char* input : inputs) {
+            std::string expected = errorOf([&] { json::JsonParser(input).parse(); });
+            assert(!expected.empty());
+            for (size_t chunkSize = 1; chunkSize <= 4; ++chunkSize) {
+                std::string actual = errorOf([&] { parseInChunks(input, chunkSize); });
+                assert(actual == expected);
+            }
+        }
+    }
+}
+
+// 模板处理器：编译期内联回调，统计数字之和
+struct SumHandler {
+    double sum = 0.0;
+    size_t strings = 0;
+    size_t maxArray = 0;
+    bool onNull() { return true; }
+    bool onBoolean(bool) { return true; }
+    bool onNumber(double n) { sum += n; return true; }
+    bool onString(std::string_view) { strings++; return true; }
+    bool onKey(std::string_view) { return true; }
+    bool onStartObject() { return true; }
+    bool onEndObject(size_t) { return true; }
+    bool onStartArray() { return true; }
+    bool onEndArray(size_t count) { maxArray = std::max(maxArray, count); return true; }
+};
+
+// 虚函数处理器：记录事件序列，遇到指定键时停止
+class RecordingHandler : public json::SaxHandler {
+public:
+    std::vector<std::string> events;
+    std::string stopAtKey;
+
+    bool onNull() override { events.push_back("null"); return true; }
+    bool onBoolean(bool b) override { events.push_back(b ? "true" : "false"); return true; }
+    bool onNumber(double n) override { events.push_back("n:" + std::to_string(static_cast<int>(n))); return true; }
+    bool onString(std::string_view s) override { events.push_back("s:" + std::string(s)); return true; }
+    bool onKey(std::string_view k) override {
+        events.push_back("k:" + std::string(k));
+        return k != stopAtKey;
+    }
+    bool onStartObject() override { events.push_back("{"); return true; }
+    bool onEndObject(size_t n) override { events.push_back("}" + std::to_string(n)); return true; }
+    bool onStartArray() override { events.push_back("["); return true; }
+    bool onEndArray(size_t n) override { events.push_back("]" + std::to_string(n)); return true; }
+};
+
+void testSaxHandler() {
+    const std::string input = R"({"a": [1, 2, 3.5], "b": {"c": "x\ty", "d": null}, "e": true})";
+
+    {
+        SumHandler handler;
+        assert(json::parseSax(input, handler));
+        assert(isClose(handler.sum, 6.5));
+        assert(handler.strings == 1);
+        assert(handler.maxArray == 3);
+    }
+
+    {
+        RecordingHandler handler;
+        assert(json::parseSax(input, handler));
+        const std::vector<std::string> expected = {
+            "{", "k:a", "[", "n:1", "n:2", "n:3", "]3", "k:b", "{", "k:c", "s:x\ty",
+            "k:d", "null", "}2", "k:e", "true", "}3"
+        };
+        assert(handler.events == expected);
+
+        // 流式解析器产生相同的事件
+        RecordingHandler streamed;
+        json::StreamingParser parser(streamed);
+        for (char c : input) {
+            parser.feed(std::string_view(&c, 1));
+        }
+        assert(parser.finish().isNull());
+        assert(streamed.events == expected);
+    }
+
+    // 处理器返回false时提前停止，不再检查剩余输入
+    {
+        RecordingHandler handler;
+        handler.stopAtKey = "b";
+        assert(!json::parseSax(R"({"a": 1, "b": 2, "c": )", handler));
+        assert(handler.events.back() == "k:b");
+    }
+
+    // 语法错误仍然抛出ParserError
+    {
+        SumHandler handler;
+        bool threw = false;
+        try {
+            json::parseSax("[1, 2", handler);
+        } catch (const json::ParserError&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+}
+
+void testLazyDocument() {
+    const std::string input = R"({
+        "skip": {"big": [1, [2, [3, {"x": "]"}]]], "s": "}{"},
+        "person": {
+            "name": "Zhang \"San\"",
+            "age": 25,
+            "address": {"city": "Beijing", "zip": null},
+            "hobbies": ["Reading", "Sports", "Programming"],
+            "active": false
+        },
+        "broken": [1, 2 3]
+    })";
+    json::LazyDocument doc(input);
+
+    // 只解码访问到的路径
+    assert(doc["person"]["name"].asString() == "Zhang \"San\"");
+    assert(isClose(doc["person"]["age"].asNumber(), 25.0));
+    assert(doc["person"]["address"]["city"].asString() == "Beijing");
+    assert(doc["person"]["address"]["zip"].isNull());
+    assert(doc["person"]["active"].asBoolean() == false);
+    assert(doc["person"]["hobbies"][2].asString() == "Programming");
+    assert(doc["person"]["hobbies"].asArray().size() == 3);
+    assert(doc.root().asObject().size() == 3);
+
+    // 与JsonValue相同的访问方式
+    const auto& person = doc.root().asObject().at("person");
+    assert(person.asObject().at("address").asObject().at("city").asString() == "Beijing");
+
+    std::vector<std::string> keys;
+    for (auto [key, value] : person.asObject()) {
+        keys.push_back(key);
+    }
+    assert((keys == std::vector<std::string>{"name", "age", "address", "hobbies", "active"}));
+
+    // 物化子树
+    assert(doc["skip"].materialize().toString() == R"({"big":[1,[2,[3,{"x":"]"}]]],"s":"}{"})");
+    assert(doc["person"]["hobbies"].raw() == R"(["Reading", "Sports", "Programming"])");
+
+    // 错误语义与JsonValue一致
+    bool threw = false;
+    try {
+        doc["person"]["missing"];
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        doc["person"]["age"].asString();
+    } catch (const std::bad_variant_access&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // 损坏的部分只在访问时报错
+    assert(doc["broken"][0].isNumber());
+    threw = false;
+    try {
+        doc["broken"][2];
+    } catch (const json::ParserError& e) {
+        threw = true;
+        assert(std::string(e.what()).find("Expected ']' after array") == 0);
+    }
+    assert(threw);
+}
+
+void testWriter() {
+    json::JsonParser parser(R"({"name": "A\"B", "list": [1, 2.5, true, null], "empty": {}, "nested": {"x": []}})");
+    auto value = parser.parse();
+
+    // 紧凑输出
+    assert(value.toString() == R"({"name":"A\"B","list":[1,2.5,true,null],"empty":{},"nested":{"x":[]}})");
+
+    // 格式化输出
+    {
+        std::string out;
+        json::WriterOptions options;
+        options.pretty = true;
+        json::JsonWriter writer(out, options);
+        writer.write(value);
+        const char* expected =
+            "{\n"
+            "  \"name\": \"A\\\"B\",\n"
+            "  \"list\": [\n"
+            "    1,\n"
+            "    2.5,\n"
+            "    true,\n"
+            "    null\n"
+            "  ],\n"
+            "  \"empty\": {},\n"
+            "  \"nested\": {\n"
+            "    \"x\": []\n"
+            "  }\n"
+            "}";
+        assert(out == expected);
+        assert(json::JsonParser(out).parse().toString() == value.toString());
+    }
+
+    // 回调输出：每块不超过缓冲区大小
+    {
+        std::string collected;
+        size_t calls = 0;
+        json::CallbackSink sink([&](const char* data, size_t size) {
+            assert(size <= 16);
+            collected.append(data, size);
+            calls++;
+            return true;
+        });
+        {
+            json::JsonWriter writer(sink, json::WriterOptions(), 16);
+            writer.write(value);
+            writer.flush();
+        }
+        assert(collected == value.toString());
+        assert(calls > 1);
+    }
+
+    // 长字符串同样按缓冲区大小分块写出
+    {
+        std::string text(100000, 'x');
+        text[50000] = '\n';
+        std::string collected;
+        size_t largest = 0;
+        json::CallbackSink sink([&](const char* data, size_t size) {
+            largest = std::max(largest, size);
+            collected.append(data, size);
+            return true;
+        });
+        {
+            json::JsonWriter writer(sink, json::WriterOptions(), 1024);
+            writer.beginArray();
+            writer.string(text);
+            writer.string(text);
+            writer.endArray();
+        }
+        assert(largest <= 1024);
+        std::string expected = json::JsonValue(json::JsonValue::Array{text, text}).toString();
+        assert(collected == expected);
+    }
+
+    // 事件接口，多个顶层值以换行分隔
+    {
+        std::string out;
+        json::JsonWriter writer(out);
+        writer.beginObject();
+        writer.key("id");
+        writer.integer(-7);
+        writer.key("tags");
+        writer.beginArray();
+        writer.string("a\tb");
+        writer.unsignedInteger(18446744073709551615ULL);
+        writer.endArray();
+        writer.endObject();
+        writer.number(0.5);
+        assert(out == "{\"id\":-7,\"tags\":[\"a\\tb\",18446744073709551615]}\n0.5");
+
+        bool threw = false;
+        try {
+            json::JsonWriter misuse(out);
+            misuse.beginObject();
+            misuse.null();
+        } catch (const json::WriterError&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // 文件输出
+    {
+        std::FILE* file = std::tmpfile();
+        assert(file);
+        {
+            json::FileSink sink(file);
+            json::JsonWriter writer(sink);
+            writer.write(value);
+        }
+        std::rewind(file);
+        std::string contents;
+        char buffer[256];
+        size_t n;
+        while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            contents.append(buffer, n);
+        }
+        std::fclose(file);
+        assert(contents == value.toString());
+    }
+
+    // 输出端拒绝数据时报错
+    {
+        json::CallbackSink sink([](const char*, size_t) { return false; });
+        json::JsonWriter writer(sink);
+        writer.write(value);
+        bool threw = false;
+        try {
+            writer.flush();
+        } catch (const json::WriterError&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+}
+
+void testStringScanning() {
+    // 向量化查找与逐字节结果一致（覆盖各向量宽度的边界）
+    {
+        std::mt19937 rng(11);
+        const char alphabet[] = "abc \"\\\x01\x1f\x7f\xc3\xa9/";
+        for (int round = 0; round < 2000; ++round) {
+            std::string s(rng() % 200, 'x');
+            for (char& c : s) {
+                if (rng() % 40 == 0) {
+                    c = alphabet[rng() % (sizeof(alphabet) - 1)];
+                }
+            }
+            size_t expected = s.size();
+            for (size_t i = 0; i < s.size(); ++i) {
+                unsigned char c = static_cast<unsigned char>(s[i]);
+                if (c == '"' || c == '\\' || c < 0x20) {
+                    expected = i;
+                    break;
+                }
+            }
+            assert(json::findStringSpecial(s.data(), s.size()) == expected);
+        }
+    }
+
+    // UTF-8 校验
+    {
+        assert(json::validateUtf8(""));
+        assert(json::validateUtf8("plain ascii"));
+        assert(json::validateUtf8("caf\xc3\xa9 \xe4\xb8\xad\xe6\x96\x87 \xf0\x9f\x98\x80"));
+        assert(json::validateUtf8("\xf4\x8f\xbf\xbf"));   // U+10FFFF
+        assert(json::validateUtf8("\xed\x9f\xbf"));        // U+D7FF
+
+        const char* invalid[] = {
+            "\x80",                 // 孤立的后续字节
+            "\xc0\x80",             // 过长编码
+            "\xc3",                 // 截断
+            "\xe0\x80\x80",         // 过长编码
+            "\xed\xa0\x80",         // 代理区
+            "\xe4\xb8",             // 截断
+            "\xf4\x90\x80\x80",     // 超过 U+10FFFF
+            "\xf5\x80\x80\x80",
+            "\xff",
+        };
+        for (const char* bytes : invalid) {
+            assert(!json::validateUtf8(bytes));
+        }
+
+        // 错误位置跨越向量块边界
+        for (size_t prefix = 0; prefix < 140; ++prefix) {
+            std::string s(prefix, 'a');
+            s += "\xc3\xa9";
+            assert(json::validateUtf8(s));
+            s += "\xe4\xb8";
+            s += std::string(70, 'b');
+            size_t offset = 0;
+            assert(!json::validateUtf8(s, &offset));
+            assert(offset == prefix + 2);
+        }
+    }
+
+    // 解析时按需校验
+    {
+        const std::string input = "[\"ok\",\n \"\xc3\x28\"]";
+        assert(json::JsonParser(input).parse().asArray()[1].asString() == "\xc3(");
+        json::ParseOptions options;
+        options.validateUtf8 = true;
+        assert(errorOf([&] { json::JsonParser(input, options).parse(); }) ==
+               "Invalid UTF-8 at line 2, column 3");
+        assert(!errorOf([&] { json::Document::parse(input, options); }).empty());
+        assert(json::JsonParser("\"\xe4\xb8\xad\"", options).parse().asString() == "\xe4\xb8\xad");
+    }
+
+    // 字符串中的控制字符在两种扫描模式下都被拒绝
+    {
+        for (json::ScanMode mode : {json::ScanMode::Sequential, json::ScanMode::Indexed}) {
+            json::JsonLexer lexer("\"tab\there\"", mode);
+            json::Token token = lexer.nextToken();
+            assert(token.type == json::TokenType::ERROR);
+            assert(token.value == "Invalid control character in string");
+            assert(token.error == json::LexErrorKind::ControlCharacter);
+        }
+        // 错误词法单元带有错误种类，调用方无需比较提示文本
+        std::pair<const char*, json::LexErrorKind> errors[] = {
+            {"tru", json::LexErrorKind::InvalidLiteral}, {"-", json::LexErrorKind::InvalidNumber},
+            {"1.e5", json::LexErrorKind::InvalidNumber}, {"\"\\x\"", json::LexErrorKind::InvalidEscape},
+            {"\"\\u12\"", json::LexErrorKind::InvalidEscape}, {"\"abc", json::LexErrorKind::UnterminatedString},
+            {"#", json::LexErrorKind::UnexpectedCharacter}};
+        for (json::ScanMode mode : {json::ScanMode::Sequential, json::ScanMode::Indexed}) {
+            for (const auto& [text, kind] : errors) {
+                json::Token token = json::JsonLexer(text, mode).nextToken();
+                assert(token.type == json::TokenType::ERROR && token.error == kind);
+            }
+        }
+        assert(json::JsonLexer("1").nextToken().error == json::LexErrorKind::None);
+        std::string longString = "\"" + std::string(100, 'a') + "\\n" + std::string(50, 'b') + "\"";
+        json::JsonLexer lexer(longString);
+        json::Token token = lexer.nextToken();
+        assert(token.type == json::TokenType::STRING && token.escaped);
+        assert(token.value.size() == 152);
+    }
+
+    // 输出：UTF-8 原样写出，只转义引号、反斜杠和控制字符
+    {
+        json::JsonValue value("a/b \xe4\xb8\xad\x7f\x01\"");
+        assert(value.toString() == "\"a/b \xe4\xb8\xad\x7f\\u0001\\\"\"");
+
+        std::string text(200, 'z');
+        text[0] = '\n';
+        text[63] = '"';
+        text[64] = '\\';
+        text[199] = '\t';
+        std::string out = json::JsonValue(text).toString();
+        assert(out.size() == text.size() + 2 + 4);
+        assert(json::JsonParser(out).parse().asString() == text);
+    }
+}
+
+void testThreadPool() {
+    json::ThreadPool pool(3);
+    assert(pool.size() == 3);
+
+    // 每个下标恰好执行一次
+    {
+        std::vector<int> hits(1000, 0);
+        pool.parallelFor(hits.size(), [&](size_t i) { hits[i]++; });
+        assert(std::all_of(hits.begin(), hits.end(), [](int n) { return n == 1; }));
+    }
+
+    // 嵌套的并行循环不会死锁
+    {
+        std::atomic<int> total{0};
+        pool.parallelFor(8, [&](size_t) {
+            pool.parallelFor(8, [&](size_t) { total++; });
+        });
+        assert(total == 64);
+    }
+
+    // 异常在所有任务结束后重新抛出
+    {
+        std::atomic<int> finished{0};
+        bool threw = false;
+        try {
+            pool.parallelFor(50, [&](size_t i) {
+                if (i == 7) {
+                    throw std::runtime_error("task failed");
+                }
+                finished++;
+            });
+        } catch (const std::runtime_error& e) {
+            threw = std::string(e.what()) == "task failed";
+        }
+        assert(threw);
+        assert(finished == 49);
+    }
+}
+
+void testNdjson() {
+    // 构造带空行、CRLF和错误记录的输入
+    std::string input;
+    std::vector<std::string> lines;
+    for (int i = 0; i < 2000; ++i) {
+        std::string line;
+        if (i % 97 == 5) {
+            line = "";
+        } else if (i % 113 == 7) {
+            line = "{\"id\": " + std::to_string(i) + ", \"broken\": }";
+        } else {
+            line = "{\"id\": " + std::to_string(i) + ", \"tags\": [\"a\", \"b\"], \"s\": \"x\\ny\"}";
+        }
+        if (i % 3 == 0) {
+            line += "\r";
+        }
+        lines.push_back(line);
+        input += line + "\n";
+    }
+    input += "  [1, 2]";  // 最后一行没有换行符
+    lines.push_back("  [1, 2]");
+
+    // 逐行串行解析作为参照
+    std::vector<json::NdjsonRecord> expected;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (lines[i].find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        json::NdjsonRecord record;
+        record.line = i + 1;
+        record.error = errorOf([&] { record.value = json::JsonParser(lines[i]).parse(); });
+        expected.push_back(std::move(record));
+    }
+
+    auto check = [&](const std::vector<json::NdjsonRecord>& records) {
+        assert(records.size() == expected.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            assert(records[i].line == expected[i].line);
+            assert(records[i].error == expected[i].error);
+            assert(records[i].value.toString() == expected[i].value.toString());
+        }
+    };
+
+    // 有序模式：不同线程数和批次大小结果一致
+    for (size_t threads : {1, 2, 4}) {
+        for (size_t batchBytes : {1, 100, 4096, 1 << 20}) {
+            json::NdjsonOptions options;
+            options.threads = threads;
+            options.batchBytes = batchBytes;
+            json::NdjsonReader reader(options);
+            check(reader.parse(input));
+        }
+    }
+
+    // 错误记录带有行号
+    {
+        json::NdjsonReader reader;
+        auto records = reader.parse("{}\n\n[1,\n\"ok\"\n");
+        assert(records.size() == 3);
+        assert(records[1].line == 3 && !records[1].ok());
+        assert(records[2].line == 4 && records[2].value.asString() == "ok");
+    }
+
+    // 无序回调模式：按行号排序后与有序结果一致
+    {
+        json::ThreadPool pool(3);
+        json::NdjsonOptions options;
+        options.batchBytes = 512;
+        json::NdjsonReader reader(pool, options);
+        std::mutex mutex;
+        std::vector<json::NdjsonRecord> records;
+        reader.parseUnordered(input, [&](json::NdjsonRecord&& record) {
+            std::lock_guard<std::mutex> lock(mutex);
+            records.push_back(std::move(record));
+        });
+        std::sort(records.begin(), records.end(),
+                  [](const json::NdjsonRecord& a, const json::NdjsonRecord& b) { return a.line < b.line; });
+        check(records);
+    }
+
+    assert(json::NdjsonReader().parse("").empty());
+}
+
+void writeFile(const std::string& path, const std::string& contents) {
+    // 写文件不能放在 assert 里：定义 NDEBUG 时 assert 的表达式不会执行
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    assert(file);
+    size_t written = std::fwrite(contents.data(), 1, contents.size(), file);
+    int closed = std::fclose(file);
+    assert(written == contents.size() && closed == 0);
+    (void)written;
+    (void)closed;
+}
+
+void testMappedFile() {
+    const std::string path = "json_mapped_file_test.json";
+    // 跨越多个页面，末尾没有填充
+    std::string input = "{\"items\": [";
+    for (int i = 0; i < 2000; ++i) {
+        input += (i ? ", " : "") + std::string("{\"id\": ") + std::to_string(i) + ", \"name\": \"item\"}";
+    }
+    input += "], \"escaped\": \"a\\u0041\", \"last\": 12345}";
+    writeFile(path, input);
+
+    // parseFile 与内存解析结果一致
+    assert(json::parseFile(path).toString() == json::JsonParser(input).parse().toString());
+
+    // 映射文档中的字符串直接引用映射的字节
+    {
+        json::MappedDocument doc(path);
+        std::string_view source = doc.source();
+        assert(source == input);
+        auto root = doc.root().asObject();
+        std::string_view name = root.at("items").asArray()[1999].asObject().at("name").asString();
+        assert(name == "item");
+        assert(name.data() >= source.data() && name.data() < source.data() + source.size());
+        // 含转义的字符串解码后存放在arena中
+        std::string_view escaped = root.at("escaped").asString();
+        assert(escaped == "aA");
+        assert(escaped.data() < source.data() || escaped.data() >= source.data() + source.size());
+        assert(root.at("last").asInt64() == 12345);
+
+        // 移动后映射仍然有效
+        json::MappedFile moved(path);
+        const char* data = moved.data();
+        json::MappedFile other(std::move(moved));
+        assert(other.data() == data && moved.data() == nullptr);
+        assert(other.view() == input);
+    }
+
+    // 空文件和错误处理
+    writeFile(path, "");
+    {
+        json::MappedFile empty(path);
+        assert(empty.size() == 0 && empty.view().empty());
+        assert(!errorOf([&] { json::parseFile(path); }).empty());
+    }
+    writeFile(path, "[1, 2");
+    assert(errorOf([&] { json::MappedDocument doc(path); }) == "Expected ']' after array at line 1, column 6");
+    std::remove(path.c_str());
+
+    bool threw = false;
+    try {
+        json::parseFile("does/not/exist.json");
+    } catch (const json::FileError& e) {
+        threw = std::string(e.what()).find("does/not/exist.json") != std::string::npos;
+    }
+    assert(threw);
+}
+
+void testParserReuse() {
+    const std::vector<std::string> messages = {
+        R"({"id": 1, "user": {"name": "alice", "roles": ["admin", "dev"]}, "note": "line\nbreak", "score": 9.5})",
+        R"({"id": 2, "user": {"name": "bob", "roles": ["dev"]}, "note": "tab\there \u00e9", "score": -3})",
+        R"({"id": 18446744073709551615, "user": {"name": "carol", "roles": []}, "note": "", "score": 1e300})",
+    };
+
+    json::JsonParser parser;
+    json::Document doc;
+    for (int round = 0; round < 3; ++round) {
+        for (const auto& message : messages) {
+            parser.parse(message, doc);
+        }
+    }
+
+    // 预热后解析到文档不再分配内存
+    size_t before = g_allocations;
+    for (int round = 0; round < 200; ++round) {
+        for (const auto& message : messages) {
+            parser.parse(message, doc);
+            assert(doc.root().isObject());
+        }
+    }
+    assert(g_allocations == before);
+
+    // 复用不影响结果
+    parser.parse(messages[1], doc);
+    auto root = doc.root().asObject();
+    assert(root.at("id").asInt64() == 2);
+    assert(root.at("user").asObject().at("name").asString() == "bob");
+    assert(root.at("note").asString() == "tab\there \xc3\xa9");
+    assert(parser.parse(messages[0]).toString() == json::JsonParser(messages[0]).parse().toString());
+
+    // 出错后文档为 null，解析器仍可继续使用
+    assert(errorOf([&] { parser.parse("{\"a\": [1, 2}", doc); }) ==
+           "Expected ']' after array at line 1, column 12");
+    assert(doc.root().isNull());
+    parser.parse(messages[2], doc);
+    assert(doc.root().asObject().at("id").asUint64() == UINT64_MAX);
+
+    // arena 复用已有的块
+    {
+        json::Arena arena(64);
+        arena.allocate(40);
+        arena.allocate(40);
+        size_t reserved = arena.bytesReserved();
+        arena.reset();
+        assert(arena.bytesUsed() == 0 && arena.bytesReserved() == reserved);
+        before = g_allocations;
+        arena.allocate(40);
+        arena.allocate(40);
+        assert(g_allocations == before);
+        arena.release();
+        assert(arena.bytesReserved() == 0);
+    }
+
+    // 移动后源 arena 为空，再分配时申请自己的块，不会写进目标的内存
+    {
+        json::Arena source(64);
+        char* first = static_cast<char*>(source.allocate(8));
+        json::Arena target(std::move(source));
+        assert(source.bytesUsed() == 0 && source.bytesReserved() == 0 && source.blockCount() == 0);
+        assert(target.bytesUsed() == 8 && target.blockCount() == 1);
+        char* other = static_cast<char*>(source.allocate(8));
+        char* next = static_cast<char*>(target.allocate(8));
+        assert(other < first || other >= first + 64);
+        assert(next > first && next < first + 64 && source.blockCount() == 1);
+        json::Arena assigned(64);
+        assigned.allocate(8);
+        assigned = std::move(target);
+        assert(target.bytesReserved() == 0 && assigned.bytesUsed() == 16);
+    }
+}
+
+void testDeepNesting() {
+    auto nested = [](size_t depth) {
+        return std::string(depth, '[') + std::string(depth, ']');
+    };
+
+    // 默认深度上限为1024
+    assert(json::JsonParser(nested(1024)).parse().isArray());
+    const std::string tooDeep = "Maximum nesting depth exceeded at line 1, column 1025";
+    assert(errorOf([&] { json::JsonParser(nested(1025)).parse(); }) == tooDeep);
+    assert(errorOf([&] { json::Document::parse(nested(1025)); }) == tooDeep);
+    assert(errorOf([&] {
+        json::ValueBuilder builder;
+        json::parseSax(nested(1025), builder);
+    }) == tooDeep);
+    assert(errorOf([&] {
+        json::StreamingParser stream;
+        stream.feed(nested(1025));
+        stream.finish();
+    }) == tooDeep);
+
+    json::ParseOptions shallow;
+    shallow.maxDepth = 2;
+    assert(json::JsonParser("{\"a\": [1]}", shallow).parse().isObject());
+    assert(errorOf([&] { json::JsonParser("{\"a\": [{}]}", shallow).parse(); }) ==
+           "Maximum nesting depth exceeded at line 1, column 8");
+
+    // 放开上限后，极深的文档解析、序列化和析构都不会爆栈
+    json::ParseOptions unlimited;
+    unlimited.maxDepth = SIZE_MAX;
+    const size_t depth = 200000;
+    std::string input = nested(depth);
+    {
+        json::JsonValue value = json::JsonParser(input, unlimited).parse();
+        assert(value.toString() == input);
+        json::JsonValue moved = std::move(value);
+        assert(moved.isArray() && moved.asArray().size() == 1);
+    }
+    {
+        std::string objects;
+        for (size_t i = 0; i < depth; ++i) {
+            objects += "{\"k\":";
+        }
+        objects += "null" + std::string(depth, '}');
+        json::JsonValue value = json::JsonParser(objects, unlimited).parse();
+        assert(value.toString() == objects);
+    }
+    {
+        json::Document doc = json::Document::parse(input, unlimited);
+        assert(doc.root().isArray());
+    }
+    {
+        json::StreamingParser stream(unlimited);
+        for (size_t i = 0; i < input.size(); i += 4096) {
+            stream.feed(std::string_view(input).substr(i, 4096));
+        }
+        assert(stream.finish().toString() == input);
+    }
+}
+
+void testQuery() {
+    const std::string text = R"({
+        "person": {
+            "name": "Zhang San",
+            "address": {"city": "Beijing", "street": "Chaoyang District"},
+            "hobbies": ["Reading", "Sports", "Programming"]
+        },
+        "a/b": 1, "m~n": 2, "10": "ten", "": "empty",
+        "items": [{"id": 1, "tags": ["x"]}, {"id": 2}, {"id": 3, "tags": []}]
+    })";
+    json::JsonValue root = json::JsonParser(text).parse();
+
+    // JSON Pointer（RFC 6901）
+    auto pointer = [&](const char* p) { return json::JsonPath::fromPointer(p).find(root); };
+    assert(pointer("/person/address/city")->asString() == "Beijing");
+    assert(pointer("/person/hobbies/1")->asString() == "Sports");
+    assert(pointer("") == &root);
+    assert(pointer("/a~1b")->asInt64() == 1);
+    assert(pointer("/m~0n")->asInt64() == 2);
+    assert(pointer("/10")->asString() == "ten");
+    assert(pointer("/")->asString() == "empty");
+    assert(pointer("/items/2/id")->asInt64() == 3);
+    assert(pointer("/missing") == nullptr);
+    assert(pointer("/person/hobbies/01") == nullptr);
+    assert(pointer("/person/hobbies/-") == nullptr);
+    assert(pointer("/person/hobbies/3") == nullptr);
+    assert(pointer("/person/name/0") == nullptr);
+
+    // JSONPath 子集
+    auto path = [&](const char* p) { return json::JsonPath::fromJsonPath(p).findAll(root); };
+    assert(path("$").size() == 1 && path("$")[0] == &root);
+    assert(path("$.person.address.city")[0]->asString() == "Beijing");
+    assert(path("$['a/b']")[0]->asInt64() == 1);
+    assert(path("$[\"m~n\"]")[0]->asInt64() == 2);
+    assert(path("$.person.hobbies[2]")[0]->asString() == "Programming");
+    assert(path("$.person.hobbies[*]").size() == 3);
+    assert(path("$.items[*].id").size() == 3 && path("$.items[*].id")[1]->asInt64() == 2);
+    assert(path("$.items.*.tags[0]").size() == 1);
+    assert(path("$.person.*").size() == 3);
+    assert(path("$.10").size() == 1 && path("$[10]").empty());
+    assert(json::JsonPath::fromJsonPath("$.items[*].id").find(root)->asInt64() == 1);
+    assert(json::JsonPath::fromJsonPath("$.a[0]").isSingular());
+    assert(!json::JsonPath::fromJsonPath("$.a[*]").isSingular());
+
+    auto queryError = [](const std::function<void()>& compile) {
+        try {
+            compile();
+        } catch (const json::QueryError& e) {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+    assert(queryError([] { json::JsonPath::fromPointer("a"); }) ==
+           "Invalid JSON Pointer 'a': must be empty or start with '/'");
+    assert(queryError([] { json::JsonPath::fromPointer("/a~2"); }) ==
+           "Invalid JSON Pointer '/a~2': '~' must be followed by '0' or '1'");
+    assert(queryError([] { json::JsonPath::fromJsonPath("person"); }) ==
+           "Invalid JSONPath 'person': expected '$' at position 0");
+    assert(queryError([] { json::JsonPath::fromJsonPath("$.a[1"); }) ==
+           "Invalid JSONPath '$.a[1': expected ']' at position 5");
+    assert(queryError([] { json::JsonPath::fromJsonPath("$.a[-1]"); }) ==
+           "Invalid JSONPath '$.a[-1]': expected index, quoted name or '*' at position 4");
+    assert(!queryError([] { json::JsonPath::fromJsonPath("$.a."); }).empty());
+    assert(!queryError([] { json::JsonPath::fromJsonPath("$['a]"); }).empty());
+
+    // 事件流上的查询与 DOM 上的结果一致
+    json::JsonQuery query = {
+        json::JsonPath::fromPointer("/person/address/city"),
+        json::JsonPath::fromPointer("/person/address"),
+        json::JsonPath::fromPointer("/items/1"),
+        json::JsonPath::fromPointer("/nothing"),
+        json::JsonPath::fromJsonPath("$.items[*].tags"),
+        json::JsonPath::fromJsonPath("$.*.hobbies[*]"),
+        json::JsonPath::fromJsonPath("$"),
+    };
+    size_t extra = query.add(json::JsonPath::fromPointer("/a~1b"));
+    assert(extra == 7 && query.size() == 8);
+    json::JsonQuery::Result streamed = query.scan(text);
+    json::JsonQuery::Result direct = query.evaluate(root);
+    assert(streamed.size() == 8 && direct.size() == 8);
+    for (size_t i = 0; i < query.size(); ++i) {
+        assert(streamed[i].size() == direct[i].size());
+        for (size_t j = 0; j < streamed[i].size(); ++j) {
+            assert(streamed[i][j].toString() == direct[i][j].toString());
+        }
+    }
+    assert(streamed[0][0].asString() == "Beijing");
+    assert(streamed[3].empty());
+    assert(streamed[4].size() == 2);
+    assert(streamed[5].size() == 3);
+    assert(streamed[6][0].toString() == root.toString());
+
+    // 所有路径都找到后停止扫描，后面的输入不再读取
+    const std::string truncated = R"({"id": 7, "user": {"name": "bob", "tags": ["a", "b"]}, "rest": [1, 2,)";
+    json::JsonQuery early = {
+        json::JsonPath::fromPointer("/user/name"),
+        json::JsonPath::fromPointer("/id"),
+        json::JsonPath::fromJsonPath("$.user.tags[*]"),
+    };
+    json::JsonQuery::Result found = early.scan(truncated);
+    assert(found[0][0].asString() == "bob");
+    assert(found[1][0].asInt64() == 7);
+    assert(found[2].size() == 2 && found[2][1].asString() == "b");
+
+    // 前缀所在的值结束后缺失的路径也算已解析
+    json::JsonQuery absent = {json::JsonPath::fromPointer("/user/age")};
+    assert(absent.scan(truncated)[0].empty());
+
+    // 需要读到出错位置时照常报错
+    json::JsonQuery late = {json::JsonPath::fromPointer("/rest/5")};
+    assert(errorOf([&] { late.scan(truncated); }) ==
+           errorOf([&] { json::JsonParser(truncated).parse(); }));
+    assert(json::JsonQuery().scan(truncated).empty());
+}
+
+void testBinding() {
+    const std::string text = R"({
+        "name": "Zhang San", "age": 25, "score": 9.5, "active": true, "level": 3,
+        "nickname": "zs", "hobbies": ["Reading", "Sports"],
+        "unknown": {"deep": [1, {"x": null}, "s\"q"], "more": [[], {}]},
+        "address": {"city": "Beijing", "street": "Chaoyang District", "zip": 100000},
+        "previous": [{"city": "Shanghai"}, {"street": "Main St"}],
+        "extra": {"k": [1, 2.5, "v"]}
+    })";
+
+    bound::Person person = json::decode<bound::Person>(text);
+    assert(person.name == "Zhang San");
+    assert(person.age == 25);
+    assert(isClose(person.score, 9.5));
+    assert(person.active);
+    assert(person.level == 3);
+    assert(person.nickname && *person.nickname == "zs");
+    assert(person.hobbies.size() == 2 && person.hobbies[1] == "Sports");
+    assert(person.address.city == "Beijing" && person.address.street == "Chaoyang District");
+    assert(person.previous.size() == 2);
+    assert(person.previous[0].city == "Shanghai" && person.previous[0].street.empty());
+    assert(person.previous[1].street == "Main St");
+    assert(person.extra.toString() == json::JsonParser(R"({"k": [1, 2.5, "v"]})").parse().toString());
+
+    // 序列化后再解码得到相同的结构
+    std::string encoded = json::encode(person);
+    bound::Person copy = json::decode<bound::Person>(encoded);
+    assert(json::encode(copy) == encoded);
+    json::JsonValue tree = json::JsonParser(encoded).parse();
+    assert(tree.asObject().at("address").asObject().at("city").asString() == "Beijing");
+    assert(tree.asObject().at("level").asInt64() == 3);
+    assert(json::encode(bound::Address{"a\"b", ""}) == R"({"city":"a\"b","street":""})");
+
+    // 解码到已有对象：缺失字段保持原值，容器先清空，null 清空 optional
+    json::decode(R"({"hobbies": ["Chess"], "nickname": null})", person);
+    assert(person.name == "Zhang San");
+    assert(person.hobbies.size() == 1 && person.hobbies[0] == "Chess");
+    assert(!person.nickname);
+
+    // 自定义字段名
+    bound::Renamed renamed = json::decode<bound::Renamed>(R"({"first_name": "Li", "ID": -42, "id": 7})");
+    assert(renamed.id == -42 && renamed.firstName == "Li");
+    assert(json::encode(renamed) == R"({"ID":-42,"first_name":"Li"})");
+
+    // 编译期完美哈希：每个字段名各占一个槽
+    using Binding = json::detail::Binding<bound::Person>;
+    for (size_t i = 0; i < Binding::kCount; ++i) {
+        assert(Binding::hash.find(Binding::names[i], Binding::names) == i);
+    }
+    assert(Binding::hash.find("nope", Binding::names) == json::detail::PerfectHash<Binding::kCount>::npos);
+    assert(Binding::hash.find("", Binding::names) == json::detail::PerfectHash<Binding::kCount>::npos);
+
+    // 类型不匹配时报告出错位置
+    auto decodeError = [](const std::string& input) {
+        return errorOf([&] { json::decode<bound::Person>(input); });
+    };
+    assert(decodeError(R"({"age": "x"})") == "Expected integer at line 1, column 9");
+    assert(decodeError(R"({"age": 1.5})") == "Expected integer at line 1, column 9");
+    assert(decodeError(R"({"level": 300})") == "Integer out of range at line 1, column 11");
+    assert(decodeError(R"({"level": -1})") == "Integer out of range at line 1, column 11");
+    assert(decodeError(R"({"name": 1})") == "Expected string at line 1, column 10");
+    assert(decodeError(R"({"name": null})") == "Expected string at line 1, column 10");
+    assert(decodeError(R"({"active": 1})") == "Expected boolean at line 1, column 12");
+    assert(decodeError(R"({"hobbies": {}})") == "Expected array at line 1, column 13");
+    assert(decodeError(R"([])") == "Expected object at line 1, column 1");
+    assert(decodeError(R"({"age": 1} x)") == "Expected end of file");
+
+    // 语法错误与 JsonParser 的报错一致
+    for (const char* input : {R"({"junk" 1})", R"({"junk": [1, 2})", R"({"junk": tru})",
+                              R"({"junk": "a\q"})", R"({"junk": {"a": 1,}})", R"({"name": "a", })",
+                              R"({"junk": [1 2]})", R"({"age": 1)"}) {
+        std::string expected = errorOf([&] { json::JsonParser(input).parse(); });
+        assert(!expected.empty());
+        assert(decodeError(input) == expected);
+    }
+    std::string deep = "{\"junk\": " + std::string(1100, '[') + std::string(1100, ']') + "}";
+    assert(decodeError(deep) == "Maximum nesting depth exceeded at line 1, column 1033");
+}
+
+void testKeyInterning() {
+    json::KeyTable keys;
+    json::ParseOptions options;
+    options.keys = &keys;
+
+    // 不同文档中的相同键共享同一份存储
+    json::Document first = json::Document::parse(R"({"host": "a", "cpu": 1, "tags": {"host": "b", "": 0}})", options);
+    json::Document second = json::Document::parse(R"({"cpu": 2, "host": "c"})", options);
+    auto a = first.root().asObject();
+    auto b = second.root().asObject();
+    assert(a.begin()[0].key.data() == b.begin()[1].key.data());
+    assert(a.begin()[1].key.data() == b.begin()[0].key.data());
+    assert(a.at("tags").asObject().begin()[0].key.data() == a.begin()[0].key.data());
+    assert(a.at("tags").asObject().begin()[1].key.empty());
+    assert(b.at("host").asString() == "c");
+
+    // 句柄查找只比较指针
+    json::InternedKey host = keys.find("host");
+    assert(host && host.view() == "host");
+    assert(host == keys.intern("host"));
+    assert(host != keys.find("cpu"));
+    assert(!keys.find("missing"));
+    assert(b.find(host)->asString() == "c");
+    assert(b.find(keys.intern("tags")) == nullptr);
+    assert(keys.find("") && keys.find("").size() == 0);
+
+    json::KeyTableStats stats = keys.stats();
+    assert(stats.keys == 4 && keys.size() == 4);
+    assert(stats.keyBytes == 4 + 3 + 4 + 0);
+    assert(stats.lookups == 9 && stats.hits == 5 && stats.rejected == 0);
+    assert(stats.memoryBytes >= stats.keyBytes);
+    assert(isClose(stats.hitRate(), 5.0 / 9.0));
+
+    // 可复用解析器和借用输入的文档同样使用键表
+    json::JsonParser parser(options);
+    json::Document doc;
+    parser.parse(R"({"cpu": 3})", doc);
+    assert(doc.root().asObject().begin()[0].key.data() == keys.find("cpu").data());
+    std::string input = R"({"host": "d", "fresh": 1})";
+    json::Document borrowed = json::Document::parseBorrowed(input, options);
+    assert(borrowed.root().asObject().find(host)->asString() == "d");
+    assert(keys.find("fresh"));
+
+    // 达到上限或冻结后不再插入，新键仍能正确解析
+    json::KeyTable small(2);
+    options.keys = &small;
+    json::Document limited = json::Document::parse(R"({"a": 1, "b": 2, "c": 3, "a": 4})", options);
+    assert(small.size() == 2 && small.stats().rejected == 1 && small.stats().hits == 1);
+    assert(limited.root().asObject().at("c").asInt64() == 3);
+    small.freeze();
+    assert(small.frozen());
+    assert(!small.intern("d") && small.intern("a"));
+    assert(small.size() == 2);
+
+    // 空句柄不会匹配未入表的空键
+    json::Document emptyKey = json::Document::parse(R"({"": 7, "a": 1})", options);
+    assert(emptyKey.root().asObject().at("").asInt64() == 7);
+    assert(emptyKey.root().asObject().find(small.find("name")) == nullptr);
+    assert(emptyKey.root().asObject().find(small.find("a"))->asInt64() == 1);
+
+    // 多线程共享同一张键表
+    json::KeyTable shared;
+    options.keys = &shared;
+    const size_t count = 64;
+    std::vector<json::Document> docs(count);
+    json::ThreadPool pool(3);
+    pool.parallelFor(count, [&](size_t i) {
+        std::string text = "{\"id\": " + std::to_string(i) + ", \"k" + std::to_string(i % 8) +
+                           "\": true, \"nested\": {\"id\": 0}}";
+        docs[i] = json::Document::parse(text, options);
+    });
+    json::InternedKey id = shared.find("id");
+    for (size_t i = 0; i < count; ++i) {
+        auto object = docs[i].root().asObject();
+        assert(object.find(id)->asInt64() == static_cast<int64_t>(i));
+        assert(object.begin()[1].key.data() == shared.find("k" + std::to_string(i % 8)).data());
+    }
+    assert(shared.size() == 10);
+    assert(shared.stats().lookups == count * 4 && shared.stats().hits == count * 4 - 10);
+}
+
+std::string fromHex(const std::string& hex) {
+    std::string out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out += static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16));
+    }
+    return out;
+}
+
+void testCbor() {
+    // RFC 8949 附录 A 的编码示例
+    auto encoded = [](const std::string& text) { return json::toCbor(json::JsonParser(text).parse()); };
+    assert(encoded("0") == fromHex("00"));
+    assert(encoded("23") == fromHex("17"));
+    assert(encoded("24") == fromHex("1818"));
+    assert(encoded("1000") == fromHex("1903e8"));
+    assert(encoded("1000000000000") == fromHex("1b000000e8d4a51000"));
+    assert(encoded("18446744073709551615") == fromHex("1bffffffffffffffff"));
+    assert(encoded("-1") == fromHex("20"));
+    assert(encoded("-1000") == fromHex("3903e7"));
+    assert(encoded("-9223372036854775808") == fromHex("3b7fffffffffffffff"));
+    assert(encoded("1.5") == fromHex("fa3fc00000"));
+    assert(encoded("1.1") == fromHex("fb3ff199999999999a"));
+    assert(encoded("true") == fromHex("f5") && encoded("false") == fromHex("f4") && encoded("null") == fromHex("f6"));
+    assert(encoded("\"a\"") == fromHex("6161"));
+    assert(encoded("\"\\u00fc\"") == fromHex("62c3bc"));
+    assert(encoded("[1, 2, 3]") == fromHex("83010203"));
+    assert(encoded(R"({"a": 1, "b": [2, 3]})") == fromHex("a26161016162820203"));
+
+    // 其他编码器可能产生的形式
+    assert(json::parseCbor(fromHex("f93e00")).asNumber() == 1.5);
+    assert(std::isinf(json::parseCbor(fromHex("f97c00")).asNumber()));
+    assert(json::parseCbor(fromHex("f90001")).asNumber() == 5.960464477539063e-8);
+    assert(json::parseCbor(fromHex("c11a514b67b0")).asInt64() == 1363896240);
+    assert(json::parseCbor(fromHex("f7")).isNull());
+    assert(json::parseCbor(fromHex("3bffffffffffffffff")).asNumber() == -18446744073709551616.0);
+    assert(json::parseCbor(fromHex("1bffffffffffffffff")).asUint64() == UINT64_MAX);
+    assert(json::parseCbor(fromHex("a0")).asObject().empty());
+
+    // 往返后值与类型不变
+    const std::string text = R"({"name": "Zhang San", "age": 25, "score": 9.75, "ratio": 0.1,
+        "big": 18446744073709551615, "neg": -42, "ok": true, "none": null, "empty": {}, "list": [],
+        "nested": {"items": [1, "two", [3.5, {"k": "v\n\u00e9"}]], "dup": 1}})";
+    json::JsonValue value = json::JsonParser(text).parse();
+    std::string cbor = json::toCbor(value);
+    assert(cbor.size() < value.toString().size());
+    json::JsonValue decoded = json::parseCbor(cbor);
+    assert(decoded.toString() == value.toString());
+    const auto& object = decoded.asObject();
+    assert(object.at("age").isInt() && object.at("age").asInt64() == 25);
+    assert(!object.at("score").isInt() && object.at("score").asNumber() == 9.75);
+    assert(object.at("ratio").asNumber() == 0.1);
+    assert(object.at("big").asUint64() == UINT64_MAX);
+    std::string appended = "x";
+    json::writeCbor(value, appended);
+    assert(appended == "x" + cbor);
+
+    // 跳过子树只读取头部
+    json::JsonValue::Array records;
+    records.push_back(value);
+    records.push_back(json::JsonValue("tail"));
+    std::string pair = json::toCbor(json::JsonValue(records));
+    size_t second = json::skipCbor(pair, 1);
+    assert(second == 1 + cbor.size());
+    assert(json::parseCbor(std::string_view(pair).substr(second)).asString() == "tail");
+    assert(json::skipCbor(pair) == pair.size());
+
+    // 错误报告
+    auto cborError = [](const std::string& data, const json::ParseOptions& options = json::ParseOptions()) {
+        try {
+            json::parseCbor(data, options);
+        } catch (const json::CborError& e) {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+    assert(cborError(fromHex("830102")) == "Unexpected end of input at offset 3");
+    assert(cborError(fromHex("9bffffffffffffffff00")) == "Unexpected end of input at offset 10");
+    assert(cborError(fromHex("7a7fffffff")) == "Unexpected end of input at offset 5");
+    assert(cborError(fromHex("a10101")) == "Map key must be a text string at offset 1");
+    assert(cborError(fromHex("9f01ff")) == "Indefinite-length items are not supported at offset 0");
+    assert(cborError(fromHex("4100")) == "Byte strings are not supported at offset 0");
+    assert(cborError(fromHex("1c")) == "Invalid additional information at offset 0");
+    assert(cborError(fromHex("f820")) == "Unsupported simple value at offset 0");
+    assert(cborError(fromHex("0000")) == "Unexpected data after item at offset 1");
+    assert(cborError("") == "Unexpected end of input at offset 0");
+    json::ParseOptions strict;
+    strict.validateUtf8 = true;
+    assert(cborError(fromHex("8262616162c328"), strict) == "Invalid UTF-8 at offset 5");
+    assert(json::parseCbor(fromHex("62c328")).asString() == "\xc3\x28");
+    bool threw = false;
+    try {
+        json::skipCbor(fromHex("8301"));
+    } catch (const json::CborError&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // 深度限制与非递归的深层往返
+    std::string deep = std::string(1025, '\x81') + '\x00';
+    assert(cborError(deep) == "Maximum nesting depth exceeded at offset 1024");
+    json::ParseOptions unlimited;
+    unlimited.maxDepth = SIZE_MAX;
+    std::string nested = std::string(200000, '[') + std::string(200000, ']');
+    std::string deepCbor = json::toCbor(json::JsonParser(nested, unlimited).parse());
+    assert(deepCbor == std::string(199999, '\x81') + '\x80');
+    assert(json::skipCbor(deepCbor) == deepCbor.size());
+    assert(json::parseCbor(deepCbor, unlimited).toString() == nested);
+}
+
+void testParallelParse() {
+    // 字符串中带引号、反斜杠、括号和逗号，块边界会落在各种位置
+    std::mt19937_64 rng(21);
+    std::string array = "[";
+    for (int i = 0; i < 400; ++i) {
+        if (i) {
+            array += i % 5 ? ", " : ",\n ";
+        }
+        switch (rng() % 5) {
+            case 0: array += std::to_string(rng() % 100000); break;
+            case 1: array += "\"a,b]\\\\\\\"{c\\\\\""; break;
+            case 2: array += "{\"k\": [1, {\"x\": \"]}\"}], \"e\": {}}"; break;
+            case 3: array += "[[], [\"\\\\\", 2.5e3, null], true]"; break;
+            default: array += "\"\\u4e2d\xe6\x96\x87\""; break;
+        }
+    }
+    array += "]\n";
+    std::string object = "{";
+    for (int i = 0; i < 300; ++i) {
+        // 重复键：保留首次出现的位置和最后的值
+        object += (i ? ", \"k" : "\"k") + std::to_string(i % 250) + "\": [" + std::to_string(i) + ", \"\\\"}\"]";
+    }
+    object += "}";
+
+    for (const std::string* input : {&array, &object}) {
+        std::string expected = json::JsonParser(*input).parse().toString();
+        for (size_t chunkBytes : {1, 7, 64, 1000, 1 << 20}) {
+            json::ParallelOptions options;
+            options.threads = 3;
+            options.chunkBytes = chunkBytes;
+            json::ParallelParser parser(options);
+            assert(parser.parse(*input).toString() == expected);
+            assert((parser.pieces() > 1) == (chunkBytes <= 1000));
+        }
+    }
+    json::ParallelOptions small;
+    small.chunkBytes = 16;
+    json::ThreadPool pool(2);
+    json::ParallelParser parser(pool, small);
+    assert(parser.parse(object).asObject().size() == 250);
+    assert(parser.parse(object).asObject().begin()->second.asArray()[0].asInt64() == 250);
+
+    // 错误与串行解析器完全相同
+    for (const std::string& bad : std::vector<std::string>{array.substr(0, array.size() - 3) + ",]", array.substr(0, 900) + "}" + array.substr(900),
+                            object.substr(0, 500) + "\"\\q" + object.substr(500), "[1, 2, 3, 4, 5, 6 7]",
+                            "{\"a\": 1, \"b\": 2, \"c\" 3, \"d\": 4}", "[\"abc, \"def\", 1, 2, 3, 4]"}) {
+        std::string expected = errorOf([&] { json::JsonParser(bad).parse(); });
+        assert(!expected.empty());
+        assert(errorOf([&] { parser.parse(bad); }) == expected);
+    }
+
+    // 中间提前闭合的顶层容器不能被某一段吞掉
+    std::string twoArrays = "[";
+    for (int i = 0; i < 2000; ++i) {
+        twoArrays += "1,";
+    }
+    twoArrays += "2],[";
+    for (int i = 0; i < 2000; ++i) {
+        twoArrays += "3,";
+    }
+    twoArrays += "4]";
+    json::ParallelOptions four;
+    four.threads = 4;
+    four.chunkBytes = 256;
+    json::ParallelParser splitter(four);
+    std::string twoArraysError = errorOf([&] { json::JsonParser(twoArrays).parse(); });
+    assert(!twoArraysError.empty());
+    assert(errorOf([&] { splitter.parse(twoArrays); }) == twoArraysError);
+    std::string twoObjects = "{\"a\": 1, \"b\": 2}, {\"c\": 3, \"d\": 4}";
+    json::ParallelParser tiny(pool, small);
+    assert(errorOf([&] { tiny.parse(twoObjects); }) ==
+           errorOf([&] { json::JsonParser(twoObjects).parse(); }));
+
+    // 深度限制从顶层容器开始计算
+    json::ParallelOptions shallow = small;
+    shallow.parse.maxDepth = 2;
+    json::ParallelParser limited(pool, shallow);
+    std::string nested = "[[1], [2], [3], [4], [5], [6], [7], [8], [[9]], [10], [11]]";
+    assert(errorOf([&] { limited.parse(nested); }) ==
+           errorOf([&] { json::JsonParser(nested, shallow.parse).parse(); }));
+
+    // 标量和小输入直接串行解析
+    assert(parser.parse(" 42 ").asInt64() == 42);
+    assert(parser.pieces() == 1);
+    assert(parser.parse("[]").asArray().empty());
+}
+
+void testParseStats() {
+    std::string input = "{\"a\": [1, 2.5, \"x\\ny\"], \"b\": {\"c\": null, \"d\": true}, "
+                        "\"long\": \"a string longer than the small buffer\"}";
+    json::JsonParser parser;
+    parser.parse(input);
+    // 复制一份：后面的解析会覆盖 parser.stats()
+    json::ParseStats stats = parser.stats();
+
+    if constexpr (!json::kStatsEnabled) {
+        // 未开启统计时所有计数为零
+        assert(stats.parses == 0 && stats.totalCycles() == 0 && stats.allocations == 0);
+        assert(stats.tokenCount(json::TokenType::STRING) == 0 && stats.maxDepth == 0);
+        return;
+    }
+
+    assert(stats.parses == 1);
+    assert(stats.tokenCount(json::TokenType::LEFT_BRACE) == 2);
+    assert(stats.tokenCount(json::TokenType::LEFT_BRACKET) == 1);
+    assert(stats.tokenCount(json::TokenType::COMMA) == 5);
+    assert(stats.tokenCount(json::TokenType::COLON) == 5);
+    assert(stats.tokenCount(json::TokenType::STRING) == 7);
+    assert(stats.tokenCount(json::TokenType::NUMBER) == 2);
+    assert(stats.tokenCount(json::TokenType::NULL_) == 1);
+    assert(stats.tokenCount(json::TokenType::END_OF_FILE) == 1);
+    assert(stats.bytesIn(json::ParsePhase::Lexing) == input.size());
+    assert(stats.bytesIn(json::ParsePhase::Numbers) == 4);
+    assert(stats.bytesIn(json::ParsePhase::Strings) == 4);  // 只统计带转义的字符串
+    assert(stats.bytesIn(json::ParsePhase::Validation) == 0);
+    assert(stats.maxDepth == 2);
+    assert(stats.largestContainer == 3);
+    assert(stats.allocations >= 1 && stats.allocatedBytes > 0);
+    assert(stats.cyclesIn(json::ParsePhase::Lexing) > 0 && stats.totalCycles() > 0);
+
+    // 每次解析重新计数；出错的解析统计到出错位置为止
+    std::string bad = "[1, [2, [3]], oops]";
+    assert(!errorOf([&] { parser.parse(bad); }).empty());
+    assert(parser.stats().parses == 1 && parser.stats().maxDepth == 3);
+    assert(parser.stats().tokenCount(json::TokenType::ERROR) == 1);
+
+    // 文档解析：复用 arena 后不再分配
+    json::Document doc;
+    parser.parse(input, doc);
+    assert(parser.stats().allocations >= 1);
+    parser.parse(input, doc);
+    assert(parser.stats().allocations == 0 && parser.stats().maxDepth == 2);
+
+    // 多个线程的统计用 += 合并
+    json::ParseStats total;
+    total += stats;
+    total += stats;
+    assert(total.parses == 2 && total.tokenCount(json::TokenType::STRING) == 14 && total.maxDepth == 2);
+    assert(total.allocations == 2 * stats.allocations && total.allocations != 2 * parser.stats().allocations);
+
+    json::NdjsonOptions options;
+    options.threads = 2;
+    options.batchBytes = 16;
+    json::NdjsonReader reader(options);
+    reader.parse("[1]\n{\"k\": [2, 3, 4, 5]}\n\n\"s\"\n");
+    assert(reader.stats().parses == 3);
+    assert(reader.stats().tokenCount(json::TokenType::NUMBER) == 5);
+    assert(reader.stats().largestContainer == 4);
+}
+
+void testJsonPatch() {
+    auto parse = [](const std::string& text) { return json::JsonParser(text).parse(); };
+    auto persistent = [&](const std::string& text) { return json::PersistentValue(parse(text)); };
+    auto patched = [&](const std::string& document, const std::string& patch) {
+        return json::applyPatch(persistent(document), parse(patch)).toJson().toString();
+    };
+    auto patchError = [&](const std::string& document, const std::string& patch) {
+        try {
+            json::applyPatch(persistent(document), parse(patch));
+        } catch (const json::PatchError& e) {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+
+    // RFC 6902 附录 A 中的例子
+    assert(patched("{\"foo\": \"bar\"}", "[{\"op\": \"add\", \"path\": \"/baz\", \"value\": \"qux\"}]") ==
+           "{\"foo\":\"bar\",\"baz\":\"qux\"}");
+    assert(patched("{\"foo\": [\"bar\", \"baz\"]}", "[{\"op\": \"add\", \"path\": \"/foo/1\", \"value\": \"qux\"}]") ==
+           "{\"foo\":[\"bar\",\"qux\",\"baz\"]}");
+    assert(patched("{\"baz\": \"qux\", \"foo\": \"bar\"}", "[{\"op\": \"remove\", \"path\": \"/baz\"}]") ==
+           "{\"foo\":\"bar\"}");
+    assert(patched("{\"foo\": [\"bar\", \"qux\", \"baz\"]}", "[{\"op\": \"remove\", \"path\": \"/foo/1\"}]") ==
+           "{\"foo\":[\"bar\",\"baz\"]}");
+    assert(patched("{\"baz\": \"qux\", \"foo\": \"bar\"}",
+                   "[{\"op\": \"replace\", \"path\": \"/baz\", \"value\": \"boo\"}]") == "{\"baz\":\"boo\",\"foo\":\"bar\"}");
+    assert(patched("{\"foo\": {\"bar\": \"baz\", \"waldo\": \"fred\"}, \"qux\": {\"corge\": \"grault\"}}",
+                   "[{\"op\": \"move\", \"from\": \"/foo/waldo\", \"path\": \"/qux/thud\"}]") ==
+           "{\"foo\":{\"bar\":\"baz\"},\"qux\":{\"corge\":\"grault\",\"thud\":\"fred\"}}");
+    assert(patched("{\"foo\": [\"all\", \"grass\", \"cows\", \"eat\"]}",
+                   "[{\"op\": \"move\", \"from\": \"/foo/1\", \"path\": \"/foo/3\"}]") ==
+           "{\"foo\":[\"all\",\"cows\",\"eat\",\"grass\"]}");
+    assert(patched("{\"foo\": [\"bar\"]}", "[{\"op\": \"add\", \"path\": \"/foo/-\", \"value\": [\"abc\", \"def\"]}]") ==
+           "{\"foo\":[\"bar\",[\"abc\",\"def\"]]}");
+    assert(patched("{\"a/b\": 1, \"m~n\": 2}", "[{\"op\": \"copy\", \"from\": \"/a~1b\", \"path\": \"/m~0n\"},"
+                   " {\"op\": \"test\", \"path\": \"/m~0n\", \"value\": 1.0}]") == "{\"a/b\":1,\"m~n\":1}");
+    assert(patched("{\"a\": 1}", "[{\"op\": \"replace\", \"path\": \"\", \"value\": [true]}]") == "[true]");
+
+    assert(patchError("{\"baz\": \"qux\"}", "[{\"op\": \"test\", \"path\": \"/baz\", \"value\": \"bar\"}]") ==
+           "Patch operation 0: test failed at '/baz'");
+    assert(patchError("{\"foo\": \"bar\"}", "[{\"op\": \"add\", \"path\": \"/baz/bat\", \"value\": \"qux\"}]") ==
+           "Patch operation 0: path '/baz' does not exist");
+    assert(patchError("[1, 2]", "[{\"op\": \"add\", \"path\": \"/3\", \"value\": 0}]") ==
+           "Patch operation 0: index '/3' is out of range");
+    assert(patchError("{\"a\": {\"b\": 1}}", "[{\"op\": \"move\", \"from\": \"/a\", \"path\": \"/a/b/c\"}]") ==
+           "Patch operation 0: cannot move a value into itself");
+    assert(patchError("{}", "[{\"op\": \"add\", \"path\": \"/x\", \"value\": 1}, {\"op\": \"frob\", \"path\": \"\"}]") ==
+           "Patch operation 1: unknown operation \"frob\"");
+    assert(patchError("{}", "[{\"op\": \"add\", \"path\": \"x\", \"value\": 1}]").find("Invalid JSON Pointer") !=
+           std::string::npos);
+    assert(patchError("{}", "[{\"op\": \"add\", \"path\": \"/x\"}]") == "Patch operation 0: missing \"value\"");
+
+    // 结构共享：只复制被修改的路径，旧版本保持不变
+    std::string config = "{\"service\": {\"name\": \"api\", \"limits\": {\"rps\": 100, \"burst\": 20}},"
+                         " \"routes\": [{\"path\": \"/a\"}, {\"path\": \"/b\"}], \"features\": {\"x\": true}}";
+    json::PersistentValue v1 = persistent(config);
+    json::PersistentValue v2 = json::applyPatch(
+        v1, parse("[{\"op\": \"replace\", \"path\": \"/service/limits/rps\", \"value\": 250}]"));
+    assert(v1.toJson().toString() == parse(config).toString());
+    assert(v2.find("service")->find("limits")->find("rps")->asNumber() == 250);
+    assert(v2.find("routes")->shares(*v1.find("routes")));
+    assert(v2.find("features")->shares(*v1.find("features")));
+    assert(v2.find("service")->find("name")->shares(*v1.find("service")->find("name")));
+    assert(!v2.find("service")->shares(*v1.find("service")));
+    assert(v1 != v2 && v1 == persistent(config));
+
+    // 补丁失败时不产生部分结果
+    assert(!patchError(config, "[{\"op\": \"remove\", \"path\": \"/features\"}, {\"op\": \"remove\", \"path\": \"/nope\"}]").empty());
+
+    // diff：只访问不共享的子树，应用后得到目标版本
+    json::JsonValue changes = json::diff(v1, v2);
+    assert(changes.toString() == "[{\"op\":\"replace\",\"path\":\"/service/limits/rps\",\"value\":250}]");
+    assert(json::diff(v2, v2).asArray().empty());
+    json::PersistentValue v3 = persistent("{\"service\": {\"name\": \"api\", \"limits\": {\"rps\": 100.0}},"
+                                          " \"routes\": [{\"path\": \"/a\"}, {\"path\": \"/c\"}, 7],"
+                                          " \"new/key\": null}");
+    for (const auto& pair : {std::make_pair(v1, v3), std::make_pair(v3, v1), std::make_pair(v2, v3)}) {
+        json::PersistentValue result = json::applyPatch(pair.first, json::diff(pair.first, pair.second));
+        assert(result.toJson().toString() == pair.second.toJson().toString());
+    }
+
+    // 旧版本可被其他线程无锁读取
+    std::string expected = v1.toJson().toString();
+    std::atomic<bool> consistent{true};
+    std::thread reader([&] {
+        for (int i = 0; i < 200; ++i) {
+            if (v1.toJson().toString() != expected) {
+                consistent = false;
+            }
+        }
+    });
+    json::PersistentValue version = v1;
+    for (int i = 0; i < 200; ++i) {
+        version = json::applyPatch(version, parse("[{\"op\": \"add\", \"path\": \"/routes/-\", \"value\": " +
+                                                  std::to_string(i) + "}]"));
+    }
+    reader.join();
+    assert(consistent && version.find("routes")->size() == 202);
+
+    // RFC 7396 合并补丁
+    auto merged = [&](const std::string& target, const std::string& patch) {
+        return json::applyMergePatch(persistent(target), parse(patch)).toJson().toString();
+    };
+    assert(merged("{\"a\": \"b\"}", "{\"a\": \"c\"}") == "{\"a\":\"c\"}");
+    assert(merged("{\"a\": \"b\"}", "{\"b\": \"c\"}") == "{\"a\":\"b\",\"b\":\"c\"}");
+    assert(merged("{\"a\": \"b\", \"b\": \"c\"}", "{\"a\": null}") == "{\"b\":\"c\"}");
+    assert(merged("{\"a\": [\"b\"]}", "{\"a\": \"c\"}") == "{\"a\":\"c\"}");
+    assert(merged("{\"a\": {\"b\": \"c\"}}", "{\"a\": {\"b\": \"d\", \"c\": null}}") == "{\"a\":{\"b\":\"d\"}}");
+    assert(merged("[1, 2]", "{\"a\": {\"bb\": {\"ccc\": null}}}") == "{\"a\":{\"bb\":{}}}");
+    assert(merged("{\"e\": null}", "{\"a\": 1}") == "{\"e\":null,\"a\":1}");
+    assert(merged("{\"a\": \"foo\"}", "null") == "null");
+    json::PersistentValue m = json::applyMergePatch(v1, parse("{\"features\": {\"y\": false}}"));
+    assert(m.find("service")->shares(*v1.find("service")));
+    assert(m.find("features")->find("x")->asBoolean() && !m.find("features")->find("y")->asBoolean());
+}
+
+void testHashing() {
+    auto parse = [](const std::string& text) { return json::JsonParser(text).parse(); };
+
+    // 内容相等：数字按精确值比较，对象成员顺序无关
+    assert(parse("{\"a\": [1, 2.5, \"x\"], \"b\": null}") == parse("{\"b\": null, \"a\": [1.0, 2.5, \"x\"]}"));
+    assert(parse("[1, 2]") != parse("[2, 1]"));
+    assert(parse("{\"a\": 1}") != parse("{\"a\": 1, \"b\": 2}"));
+    assert(parse("{\"a\": 1}") != parse("{\"b\": 1}"));
+    assert(parse("[true]") != parse("[1]"));
+    assert(parse("\"1\"") != parse("1"));
+    assert(parse("-0.0") == parse("0"));
+    assert(parse("18446744073709551615") == json::JsonValue(uint64_t(18446744073709551615ULL)));
+    assert(parse("9007199254740993") != parse("9007199254740992.0"));
+    assert(parse("{}") == parse("{}") && parse("[]") != parse("{}"));
+
+    // 相等的值哈希相同，不同的值（大概率）不同
+    std::vector<std::string> texts = {
+        "null", "true", "false", "0", "1", "-1", "1.5", "\"\"", "\"a\"", "\"1\"", "[]", "{}",
+        "[null]", "[[]]", "[1, 2]", "[2, 1]", "{\"a\": 1}", "{\"a\": 2}", "{\"b\": 1}",
+        "{\"a\": 1, \"b\": 2}", "[\"a\", \"b\"]", "[\"ab\"]", "\"0123456789abcdefg\"",
+        "18446744073709551615", "1e300", "[{\"a\": [true, null]}, 3]"};
+    std::unordered_set<uint64_t> hashes;
+    for (const std::string& text : texts) {
+        json::JsonValue value = parse(text);
+        uint64_t hash = json::hashValue(value);
+        hashes.insert(hash);
+        // 流式哈希与持久化值的哈希都与树上计算的一致
+        assert(json::hashJson(text) == hash);
+        assert(json::PersistentValue(value).hash() == hash);
+    }
+    assert(hashes.size() == texts.size());
+    assert(json::hashValue(parse("1")) == json::hashValue(parse("1.0")));
+    assert(json::hashValue(parse("-0.0")) == json::hashValue(parse("0")));
+    assert(json::hashValue(parse("{\"a\": 1, \"b\": [2]}")) == json::hashValue(parse("{\"b\": [2.0], \"a\": 1}")));
+    // 重复键：解析器保留最后的值，流式哈希则计入每一次出现
+    assert(json::hashValue(parse("{\"a\": 1, \"a\": 2}")) == json::hashJson("{\"a\": 2}"));
+    assert(json::hashJson("{\"a\": 1, \"a\": 2}") != json::hashJson("{\"a\": 2}"));
+    assert(json::hashJson("{\"k\": \"\\u00e9\"}") == json::hashJson("{\"k\": \"\u00e9\"}"));
+
+    // 哈希只取决于内容，固定值可跨进程保存和比较
+    assert(json::hashValue(parse("null")) == json::detail::hashNull());
+    assert(json::hashValue(parse("[]")) == json::detail::arrayHashFinish(json::detail::arrayHashStart(), 0));
+    assert(json::detail::hashBytes("hello") == json::detail::hashBytes(std::string("hello")));
+    assert(json::detail::hashBytes("hello") != json::detail::hashBytes(std::string_view("hello\0", 6)));
+
+    // std::hash 与无序容器
+    std::unordered_set<json::JsonValue> values;
+    values.insert(parse("{\"id\": 1, \"tags\": [\"a\"]}"));
+    values.insert(parse("{\"tags\": [\"a\"], \"id\": 1.0}"));
+    values.insert(parse("{\"id\": 2, \"tags\": [\"a\"]}"));
+    assert(values.size() == 2 && values.count(parse("{\"id\": 2, \"tags\": [\"a\"]}")) == 1);
+
+    // 持久化值：缓存的哈希随版本更新，未改动的子树沿用旧缓存
+    json::PersistentValue v1(parse("{\"config\": {\"x\": [1, 2, 3]}, \"n\": 0}"));
+    json::PersistentValue v2 = v1.setMember("n", 1);
+    json::PersistentValue v3 = v2.setMember("n", 0);
+    assert(v1.hash() != v2.hash() && v1.hash() == v3.hash());
+    assert(v1 == v3 && v1 != v2 && !v1.shares(v3));
+    assert(std::hash<json::PersistentValue>{}(v3) == std::hash<json::JsonValue>{}(v3.toJson()));
+    assert(json::PersistentValue(parse("[9007199254740993]")) != json::PersistentValue(parse("[9007199254740992.0]")));
+
+    // 深层嵌套不递归
+    std::string deep(100000, '[');
+    deep += std::string(100000, ']');
+    json::ParseOptions options;
+    options.maxDepth = 200000;
+    json::JsonValue a = json::JsonParser(deep, options).parse();
+    json::JsonValue b = json::JsonParser(deep, options).parse();
+    assert(a == b && json::hashValue(a) == json::hashValue(b));
+    assert(json::hashJson(deep, options) == json::hashValue(a));
+}
+
+void testValidation() {
+    using json::ValidationError;
+    auto errorAt = [](const std::string& text, const json::ValidateOptions& options = json::ValidateOptions()) {
+        json::ValidationResult result = json::validate(text, options);
+        return std::make_pair(result.error, result.offset);
+    };
+
+    // 接受与拒绝的输入与 JsonParser 完全一致
+    std::vector<std::string> inputs = {
+        "{}", "[]", "0", "-0.5e+3", "\"\"", "true", "null", " \n[1, {\"a\": [null, false]}, \"x\\u00e9\"]\t",
+        "{\"a\": {\"b\": {}}, \"c\": []}", "18446744073709551616", "01", "1e308", "[[[[]]]]",
+        "", " ", "[", "]", "{", "}", "[1,]", "[1 2]", "{\"a\"}", "{\"a\": }", "{\"a\": 1,}", "{1: 2}",
+        "{\"a\": 1]", "[1}", "1 2", "[] x", "tru", "nul", "-", "1.", "1e", "1e400", "-1e400",
+        "\"abc", "\"\\x\"", "\"\\u12g4\"", "\"a\nb\"", "@", "[1, @]", "{\"a\" 1}", "[\"a\" : 1]"};
+    for (const std::string& input : inputs) {
+        bool parsed = true;
+        try {
+            json::JsonParser(input).parse();
+        } catch (const std::exception&) {
+            parsed = false;
+        }
+        assert(json::validate(input).ok() == parsed);
+    }
+
+    // 错误码与出错位置
+    assert(errorAt("") == std::make_pair(ValidationError::ExpectedValue, size_t(0)));
+    assert(errorAt("[1, 2") == std::make_pair(ValidationError::ExpectedArrayEnd, size_t(5)));
+    assert(errorAt("[1,]") == std::make_pair(ValidationError::ExpectedValue, size_t(3)));
+    assert(errorAt("{\"a\": 1, 2}") == std::make_pair(ValidationError::ExpectedKey, size_t(9)));
+    assert(errorAt("{\"a\" 1}") == std::make_pair(ValidationError::ExpectedColon, size_t(5)));
+    assert(errorAt("{\"a\": 1]") == std::make_pair(ValidationError::ExpectedObjectEnd, size_t(7)));
+    assert(errorAt("[] []") == std::make_pair(ValidationError::TrailingContent, size_t(3)));
+    assert(errorAt("[truth]") == std::make_pair(ValidationError::InvalidLiteral, size_t(1)));
+    assert(errorAt("[1, -]") == std::make_pair(ValidationError::InvalidNumber, size_t(4)));
+    assert(errorAt("[1e999]") == std::make_pair(ValidationError::NumberOutOfRange, size_t(1)));
+    assert(errorAt("[\"\\q\"]") == std::make_pair(ValidationError::InvalidEscape, size_t(1)));
+    assert(errorAt("\"\\u00\"") == std::make_pair(ValidationError::InvalidEscape, size_t(0)));
+    assert(errorAt("\"a\tb\"") == std::make_pair(ValidationError::ControlCharacter, size_t(0)));
+    assert(errorAt("[\"abc") == std::make_pair(ValidationError::UnterminatedString, size_t(1)));
+    assert(errorAt("[#]") == std::make_pair(ValidationError::UnexpectedCharacter, size_t(1)));
+    assert(std::string(json::validationMessage(ValidationError::ExpectedColon)) == "Expected ':' after key");
+
+    // 可配置的限制
+    json::ValidateOptions limits;
+    limits.maxSize = 8;
+    assert(errorAt("[1, 2, 3, 4]", limits) == std::make_pair(ValidationError::TooLarge, size_t(8)));
+    assert(json::validate("[1, 2]", limits));
+    limits = json::ValidateOptions();
+    limits.maxDepth = 2;
+    assert(json::validate("[[1], {\"a\": 2}]", limits) && !json::validate("[[1], {\"a\": []}]", limits));
+    assert(errorAt("[[[1]]]", limits) == std::make_pair(ValidationError::TooDeep, size_t(2)));
+    assert(errorAt("{\"a\": {\"b\": {}}}", limits) == std::make_pair(ValidationError::TooDeep, size_t(12)));
+    limits = json::ValidateOptions();
+    limits.maxStringLength = 3;
+    assert(json::validate("{\"abc\": \"def\"}", limits));
+    assert(errorAt("{\"abcd\": 1}", limits) == std::make_pair(ValidationError::StringTooLong, size_t(1)));
+    assert(errorAt("[\"abc\", \"de\\n\"]", limits) == std::make_pair(ValidationError::StringTooLong, size_t(8)));
+    limits = json::ValidateOptions();
+    limits.maxMembers = 2;
+    assert(json::validate("[[1, 2], {\"a\": 1, \"b\": [3, 4]}]", limits));
+    assert(errorAt("[1, 2, 3]", limits) == std::make_pair(ValidationError::TooManyMembers, size_t(7)));
+    assert(errorAt("{\"a\": 1, \"b\": 2, \"c\": 3}", limits) == std::make_pair(ValidationError::TooManyMembers, size_t(17)));
+    limits.maxMembers = 0;
+    assert(json::validate("[{}, []]", json::ValidateOptions()) && json::validate("[]", limits));
+    assert(errorAt("[0]", limits) == std::make_pair(ValidationError::TooManyMembers, size_t(1)));
+    limits = json::ValidateOptions();
+    limits.validateUtf8 = true;
+    assert(json::validate("\"\xc3\xa9\"", limits));
+    assert(errorAt("[\"a\", \"\xc3\x28\"]", limits) == std::make_pair(ValidationError::InvalidUtf8, size_t(7)));
+    assert(json::validate("[\"a\", \"\xc3\x28\"]"));
+
+    // 不分配内存，包括出错时
+    std::string large = "[";
+    for (int i = 0; i < 2000; ++i) {
+        large += "{\"id\": " + std::to_string(i) + ", \"name\": \"item\\t" + std::to_string(i) +
+                 "\", \"tags\": [\"a\", \"b\"], \"score\": 1.25e3, \"ok\": true},";
+    }
+    large += "null]";
+    std::string nested = std::string(1000, '[') + std::string(1000, ']');
+    std::string truncated = large.substr(0, large.size() - 1);
+    std::string tooDeep(1025, '[');
+    size_t before = g_allocations;
+    assert(json::validate(large) && json::validate(nested));
+    assert(!json::validate(truncated));
+    assert(json::validate(tooDeep).error == ValidationError::TooDeep);
+    assert(g_allocations == before);
+
+    // 放宽深度限制后超过内联容量的部分才使用堆
+    json::ValidateOptions deep;
+    deep.maxDepth = 100000;
+    std::string deeper = std::string(100000, '[') + std::string(100000, ']');
+    assert(json::validate(deeper, deep));
+    assert(errorAt("[" + deeper + "]", deep) == std::make_pair(ValidationError::TooDeep, size_t(100000)));
+}
+
 void testComplexExample() {
     const char* json = R"({
         "name": "John Doe",
@@ -176,9 +2207,33 @@ void testComplexExample() {
 int main() {
     try {
         testBasicTypes();
+        testNumbers();
         testArrays();
         testObjects();
+        testObjectOrder();
         testStringEscaping();
+        testZeroCopyLexer();
+        testStructuralIndex();
+        testArenaDocument();
+        testStreamingParser();
+        testSaxHandler();
+        testLazyDocument();
+        testWriter();
+        testStringScanning();
+        testThreadPool();
+        testNdjson();
+        testMappedFile();
+        testParserReuse();
+        testDeepNesting();
+        testQuery();
+        testBinding();
+        testKeyInterning();
+        testCbor();
+        testParallelParse();
+        testParseStats();
+        testJsonPatch();
+        testHashing();
+        testValidation();
         testComplexExample();
         
         std::cout << "All tests passed!" << std::endl;